@@ -0,0 +1,89 @@
+/*
+ *  LispE
+ *
+ * Copyright 2020-present NAVER Corp.
+ * The 3-Clause BSD License
+ */
+//  benchapl.cxx
+//
+//  Prefix sums (scan, backscan) on vectors of 1M values and outer product tables (°) of 1000 x 1000,
+//  on numbers, floats and integers (the native loops on the buffers), compared with the same
+//  expressions on lists of the same values, which go through the generic path (one call per value).
+//  Usage: bin/benchapl [size]
+
+#include "lispe.h"
+#include "benchtools.h"
+#include <math.h>
+
+//Both results must contain the same values, whatever their containers
+static bool same(Element* a, Element* b) {
+    if (a->isList() != b->isList())
+        return false;
+    if (!a->isList())
+        return (fabs(a->asNumber() - b->asNumber()) <= 1e-6 * std::max(1.0, fabs(a->asNumber())));
+    if (a->size() != b->size())
+        return false;
+    for (long i = 0; i < a->size(); i++) {
+        if (!same(a->index(i), b->index(i)))
+            return false;
+    }
+    return true;
+}
+
+static double timing(LispE& lisp, string code, Element*& result) {
+    Element* tree = lisp.compile(code);
+    return bench_time([&]() {
+        if (result != NULL)
+            result->release();
+        try {
+            result = tree->eval(&lisp);
+        }
+        catch (Error* err) {
+            printf("%s: %s\n", code.c_str(), err->toString(&lisp).c_str());
+            result = err;
+        }
+    });
+}
+
+static void measure(LispE& lisp, const char* label, string native, string generic) {
+    Element* n = NULL;
+    Element* g = NULL;
+    double tn = timing(lisp, native, n);
+    double tg = timing(lisp, generic, g);
+    if (n->isError() || g->isError())
+        printf("%-28s error\n", label);
+    else {
+        if (!same(n, g))
+            printf("%-28s the results differ\n", label);
+        printf("%-28s %12.2f %12.2f %8.2f\n", label, tn, tg, tn ? tg / tn : 0);
+    }
+    n->release();
+    g->release();
+}
+
+int main(int argc, char *argv[]) {
+    long size = 1000000;
+    if (argc > 1)
+        size = atol(argv[1]);
+    if (size <= 0)
+        size = 1000000;
+    long table = 1000;
+
+    LispE lisp;
+    char buffer[500];
+    //Values stay small so that the sums on floats remain exact
+    sprintf(buffer, "(setq vi (% (iota %ld) 7)) (setq vn (numbers vi)) (setq vf (floats vi)) (setq li (to_list vi)) (setq ln (to_list vn)) (setq lf (to_list vf))", size);
+    lisp.execute(buffer);
+    sprintf(buffer, "(setq ti (iota %ld)) (setq tn (numbers ti)) (setq lti (to_list ti)) (setq ltn (to_list tn))", table);
+    lisp.execute(buffer);
+
+    printf("%-28s %12s %12s %8s\n", "expression", "native ms", "generic ms", "speedup");
+    measure(lisp, "scan '+ numbers", "(scan '+ vn)", "(scan '+ ln)");
+    measure(lisp, "scan '+ floats", "(scan '+ vf)", "(scan '+ lf)");
+    measure(lisp, "scan '+ integers", "(scan '+ vi)", "(scan '+ li)");
+    measure(lisp, "backscan '+ numbers", "(backscan '+ vn)", "(backscan '+ ln)");
+    measure(lisp, "scan '- integers", "(scan '- vi)", "(scan '- li)");
+    measure(lisp, "° '* numbers", "(° tn '* tn)", "(° ltn '* ltn)");
+    measure(lisp, "° '+ integers", "(° ti '+ ti)", "(° lti '+ lti)");
+    measure(lisp, "° '< integers", "(° ti '< ti)", "(° lti '< lti)");
+}
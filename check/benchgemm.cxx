@@ -0,0 +1,88 @@
+/*
+ *  LispE
+ *
+ * Copyright 2020-present NAVER Corp.
+ * The 3-Clause BSD License
+ */
+//  benchgemm.cxx
+//
+//  Matrix product of (. m1 '+ '* m2) on n x n matrices (matrix_product, the GEMM path),
+//  compared with a plain triple loop over the same values.
+//  Usage: bin/benchgemm [n1 n2 ...], 256 1024 2048 by default
+
+#include "lispe.h"
+#include "benchtools.h"
+#include <math.h>
+
+//The reference is only computed up to this size, beyond it takes too long
+const long reference_limit = 1024;
+
+static Matrice* random_matrix(LispE& lisp, long n, bench_random& rnd) {
+    Matrice* m = new Matrice(&lisp, n, n, 0.0);
+    for (long i = 0; i < n; i++) {
+        Numbers* row = (Numbers*)m->liste[i];
+        for (long j = 0; j < n; j++)
+            row->liste[j] = rnd.next(2000) / 1000.0 - 1;
+    }
+    return m;
+}
+
+static void reference_product(Matrice* a, Matrice* b, vector<double>& c, long n) {
+    c.assign(n * n, 0);
+    for (long i = 0; i < n; i++) {
+        Numbers* arow = (Numbers*)a->liste[i];
+        for (long j = 0; j < n; j++) {
+            double s = 0;
+            for (long k = 0; k < n; k++)
+                s += arow->liste[k] * ((Numbers*)b->liste[k])->liste[j];
+            c[i * n + j] = s;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    vector<long> sizes;
+    for (long i = 1; i < argc; i++) {
+        if (atol(argv[i]) > 0)
+            sizes.push_back(atol(argv[i]));
+    }
+    if (!sizes.size())
+        sizes = {256, 1024, 2048};
+
+    LispE lisp;
+    bench_random rnd;
+
+    printf("%-6s %12s %10s %14s %10s %8s %12s\n", "n", "gemm ms", "GFLOP/s", "reference ms", "GFLOP/s", "speedup", "max error");
+    for (long n : sizes) {
+        Matrice* a = random_matrix(lisp, n, rnd);
+        Matrice* b = random_matrix(lisp, n, rnd);
+        double flops = 2.0 * n * n * n;
+
+        Element* c = NULL;
+        double gemm = bench_time([&]() {
+            if (c != NULL)
+                c->release();
+            c = matrix_product(&lisp, a, b);
+        }, 1);
+        printf("%-6ld %12.2f %10.2f", n, gemm, flops / gemm / 1e6);
+
+        if (n > reference_limit) {
+            printf(" %14s %10s %8s %12s\n", "-", "-", "-", "-");
+        }
+        else {
+            vector<double> r;
+            double reference = bench_time([&]() {reference_product(a, b, r, n);}, 1);
+            double error = 0;
+            for (long i = 0; i < n; i++) {
+                Numbers* row = (Numbers*)((Matrice*)c)->liste[i];
+                for (long j = 0; j < n; j++)
+                    error = std::max(error, fabs(row->liste[j] - r[i * n + j]));
+            }
+            printf(" %14.2f %10.2f %8.2f %12.3g\n", reference, flops / reference / 1e6, reference / gemm, error);
+        }
+
+        c->release();
+        a->release();
+        b->release();
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ *  LispE
+ *
+ * Copyright 2020-present NAVER Corp.
+ * The 3-Clause BSD License
+ */
+//  benchparse.cxx
+//
+//  Parse throughput in MB/s on a generated LispE data file (quoted lists, numbers and strings):
+//  segmenting alone, then segmenting and the construction of the syntax tree (compile).
+//  Usage: bin/benchparse [size in MB]
+
+#include "lispe.h"
+#include "benchtools.h"
+
+//A data file such as the ones we load: quoted records of numbers, strings and keywords
+static string data_file(long size) {
+    static const char* keys[] = {"name", "city", "age", "score", "tags", "active"};
+    static const char* values[] = {"\"Paris\"", "\"東京\"", "\"Zürich\"", "\"a string with spaces\"", "true", "nil"};
+    bench_random rnd;
+    //Atoms are encoded on 16 bits, the records are then kept in one single variable
+    string code = "(setq records '(\n";
+    char buffer[100];
+    while (code.size() < size) {
+        code += "(";
+        long nb = 4 + rnd.next(8);
+        for (long i = 0; i < nb; i++) {
+            switch (rnd.next(4)) {
+                case 0:
+                    sprintf(buffer, "%ld ", rnd.next(1000000) - 500000);
+                    break;
+                case 1:
+                    sprintf(buffer, "%.4f ", rnd.next(1000000) / 997.0);
+                    break;
+                case 2:
+                    sprintf(buffer, "(%s %s) ", keys[rnd.next(6)], values[rnd.next(6)]);
+                    break;
+                default:
+                    sprintf(buffer, "(%ld %ld %ld) ", rnd.next(100), rnd.next(1000), rnd.next(10000));
+            }
+            code += buffer;
+        }
+        code += ")\n";
+    }
+    code += "))\n";
+    return code;
+}
+
+int main(int argc, char *argv[]) {
+    long size = 4;
+    if (argc > 1)
+        size = atol(argv[1]);
+    if (size <= 0)
+        size = 4;
+
+    string code = data_file(size << 20);
+    LispE lisp;
+
+    long nbtokens = 0;
+    double segmenting = bench_time([&]() {
+        Tokenizer parse;
+        if (lisp.segmenting(code, parse) != e_no_error)
+            printf("Segmenting error\n");
+        nbtokens = parse.tokens.size();
+    });
+
+    bool error = false;
+    double compiling = bench_time([&]() {
+        string c = code;
+        Element* e = lisp.compile(c);
+        error = e->isError();
+    });
+    if (error)
+        printf("Compiling error\n");
+
+    printf("Data file: %.2f MB, %ld tokens\n\n", code.size() / 1048576.0, nbtokens);
+    printf("%-12s %10s %10s\n", "", "ms", "MB/s");
+    printf("%-12s %10.2f %10.2f\n", "segmenting", segmenting, bench_mbs(code.size(), segmenting));
+    printf("%-12s %10.2f %10.2f\n", "compile", compiling, bench_mbs(code.size(), compiling));
+}
@@ -0,0 +1,96 @@
+/*
+ *  LispE
+ *
+ * Copyright 2020-present NAVER Corp.
+ * The 3-Clause BSD License
+ */
+//  benchregex.cxx
+//
+//  Throughput of the rgx engine (Au_automaton): match, search, find and searchall
+//  on a log-like corpus, with the lazy DFA and with the NFA alone.
+//  Usage: bin/benchregex [size in MB]
+
+#include "rgx.h"
+#include "benchtools.h"
+
+//The literal prefilter is switched off in both modes, to only measure the DFA
+static void dfa_mode(Au_automaton& au, bool lazy) {
+    au.reset();
+    au.dfa = new Au_dfa(au.first);
+    au.dfa->filtering = false;
+    au.dfa->overflow = !lazy;
+}
+
+//Each operation is applied to every line of the corpus: the NFA recursion goes down
+//one level per character, which a multi-megabyte single string would not survive
+static double run(Au_automaton& au, string op, vector<u_ustring>& lines, long& found) {
+    return bench_time([&]() {
+        found = 0;
+        for (auto& l : lines) {
+            if (op == "match")
+                found += au.match(l);
+            else if (op == "search")
+                found += au.search(l);
+            else if (op == "find") {
+                for (long i = au.find(l, 0); i != -1; i = au.find(l, i + 1))
+                    found++;
+            }
+            else {
+                vecte_a<long> res;
+                au.searchall(l, res);
+                found += res.size() >> 1;
+            }
+        }
+    });
+}
+
+int main(int argc, char *argv[]) {
+    long size = 1;
+    if (argc > 1)
+        size = atol(argv[1]);
+    if (size <= 0)
+        size = 1;
+
+    //Au_meta relies on the UTF-8 tables of a LispE instance
+    LispE lisp;
+    Au_meta::met = lisp.handlingutf8;
+
+    string corpus = bench_corpus(size << 20, true);
+    u_ustring text;
+    s_utf8_to_unicode(text, (unsigned char*)corpus.c_str(), corpus.size());
+    vector<u_ustring> lines;
+    long b = 0;
+    for (long i = 0; i < text.size(); i++) {
+        if (text[i] == '\n') {
+            lines.push_back(text.substr(b, i - b));
+            b = i + 1;
+        }
+    }
+
+    const char* patterns[] = {"%d+-%d+-%d+ ?*ERROR?*", "?*user_id=%d+ ?*", "ERROR", "user_id=%d+", "%d+:%d+:%d+", "%d+ ms", "{%s%p}"};
+    const char* operations[] = {"match", "search", "find", "searchall"};
+
+    printf("Corpus: %ld lines, %.2f MB\n\n", (long)lines.size(), corpus.size() / 1048576.0);
+    printf("%-24s %-10s %10s %12s %12s %8s\n", "pattern", "operation", "found", "NFA MB/s", "DFA MB/s", "speedup");
+    for (auto p : patterns) {
+        string s = p;
+        u_ustring u;
+        s_utf8_to_unicode(u, (unsigned char*)s.c_str(), s.size());
+        Au_automaton au(u);
+        if (au.first == NULL) {
+            printf("%-24s cannot be compiled\n", p);
+            continue;
+        }
+        for (auto op : operations) {
+            long found_nfa, found_dfa;
+            dfa_mode(au, false);
+            double nfa = run(au, op, lines, found_nfa);
+            dfa_mode(au, true);
+            double dfa = run(au, op, lines, found_dfa);
+            if (found_nfa != found_dfa)
+                printf("%-24s %-10s mismatch: %ld (NFA) != %ld (DFA)\n", p, op, found_nfa, found_dfa);
+            printf("%-24s %-10s %10ld %12.2f %12.2f %8.2f\n", p, op, found_dfa,
+                   bench_mbs(corpus.size(), nfa), bench_mbs(corpus.size(), dfa), dfa ? nfa / dfa : 0);
+        }
+    }
+}
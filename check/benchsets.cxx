@@ -0,0 +1,141 @@
+/*
+ *  LispE
+ *
+ * Copyright 2020-present NAVER Corp.
+ * The 3-Clause BSD License
+ */
+//  benchsets.cxx
+//
+//  Set algebra (&&&, |||, ^^^) between two seti, setn or sets of 1M elements,
+//  and between a set of 1M elements and a set of 10K elements.
+//  The merge of list_and, list_or and list_xor is compared with a lookup of
+//  each element in the other set, which is the path taken for other containers.
+//  Usage: bin/benchsets [size]
+
+#include "lispe.h"
+#include "benchtools.h"
+
+//The lookup path: one search and one insertion without hint per element
+template <class T> static void lookup_and(std::set<T>& a, std::set<T>& b, std::set<T>& r) {
+    for (auto& e : a) {
+        if (b.find(e) != b.end())
+            r.insert(e);
+    }
+}
+
+template <class T> static void lookup_or(std::set<T>& a, std::set<T>& b, std::set<T>& r) {
+    r = a;
+    for (auto& e : b)
+        r.insert(e);
+}
+
+template <class T> static void lookup_xor(std::set<T>& a, std::set<T>& b, std::set<T>& r) {
+    std::set<T> intersection;
+    lookup_and(a, b, intersection);
+    for (auto& e : a) {
+        if (intersection.find(e) == intersection.end())
+            r.insert(e);
+    }
+    for (auto& e : b) {
+        if (intersection.find(e) == intersection.end())
+            r.insert(e);
+    }
+}
+
+static u_ustring tag(long e) {
+    char buffer[30];
+    sprintf(buffer, "tag_%ld", e);
+    u_ustring u;
+    s_utf8_to_unicode(u, (unsigned char*)buffer, strlen(buffer));
+    return u;
+}
+
+template <class S, class T> static void measure(LispE& lisp, const char* label, S* a, S* b) {
+    const char* operators[] = {"&&&", "|||", "^^^"};
+    for (long op = 0; op < 3; op++) {
+        std::set<T> reference;
+        double lookup = bench_time([&]() {
+            reference.clear();
+            switch (op) {
+                case 0:
+                    lookup_and(a->ensemble, b->ensemble, reference);
+                    break;
+                case 1:
+                    lookup_or(a->ensemble, b->ensemble, reference);
+                    break;
+                default:
+                    lookup_xor(a->ensemble, b->ensemble, reference);
+            }
+        });
+
+        Element* result = NULL;
+        double merge = bench_time([&]() {
+            if (result != NULL)
+                result->release();
+            switch (op) {
+                case 0:
+                    result = a->list_and(&lisp, b);
+                    break;
+                case 1:
+                    result = a->list_or(&lisp, b);
+                    break;
+                default:
+                    result = a->list_xor(&lisp, b);
+            }
+        });
+
+        if (((S*)result)->ensemble != reference)
+            printf("%-22s %s: the results differ\n", label, operators[op]);
+        printf("%-22s %-4s %10ld %12.2f %12.2f %8.2f\n", label, operators[op], (long)reference.size(), lookup, merge, merge ? lookup / merge : 0);
+        result->release();
+    }
+}
+
+int main(int argc, char *argv[]) {
+    long size = 1000000;
+    if (argc > 1)
+        size = atol(argv[1]);
+    if (size <= 0)
+        size = 1000000;
+    long small = size / 100;
+
+    LispE lisp;
+    bench_random rnd;
+
+    //Values are drawn in [0, 2*size[, hence about half of the elements are shared
+    Set_i* ia = lisp.provideSet_i();
+    Set_i* ib = lisp.provideSet_i();
+    Set_i* ic = lisp.provideSet_i();
+    Set_n* na = lisp.provideSet_n();
+    Set_n* nb = lisp.provideSet_n();
+    Set_n* nc = lisp.provideSet_n();
+    Set_s* sa = lisp.provideSet_s();
+    Set_s* sb = lisp.provideSet_s();
+    Set_s* sc = lisp.provideSet_s();
+    while (ia->ensemble.size() < size)
+        ia->ensemble.insert(rnd.next(size << 1));
+    while (ib->ensemble.size() < size)
+        ib->ensemble.insert(rnd.next(size << 1));
+    while (ic->ensemble.size() < small)
+        ic->ensemble.insert(rnd.next(size << 1));
+    for (auto& e : ia->ensemble) {
+        na->ensemble.insert(e / 3.0);
+        sa->ensemble.insert(tag(e));
+    }
+    for (auto& e : ib->ensemble) {
+        nb->ensemble.insert(e / 3.0);
+        sb->ensemble.insert(tag(e));
+    }
+    for (auto& e : ic->ensemble) {
+        nc->ensemble.insert(e / 3.0);
+        sc->ensemble.insert(tag(e));
+    }
+
+    printf("%-22s %-4s %10s %12s %12s %8s\n", "sets", "op", "size", "lookup ms", "merge ms", "speedup");
+    measure<Set_i, long>(lisp, "seti large/large", ia, ib);
+    measure<Set_i, long>(lisp, "seti large/small", ia, ic);
+    measure<Set_n, double>(lisp, "setn large/large", na, nb);
+    measure<Set_n, double>(lisp, "setn large/small", na, nc);
+    measure<Set_s, u_ustring>(lisp, "sets large/large", sa, sb);
+    measure<Set_s, u_ustring>(lisp, "sets large/small", sa, sc);
+}
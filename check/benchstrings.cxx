@@ -0,0 +1,95 @@
+/*
+ *  LispE
+ *
+ * Copyright 2020-present NAVER Corp.
+ * The 3-Clause BSD License
+ */
+//  benchstrings.cxx
+//
+//  Per method throughput of the case conversions and character predicates of Chaine_UTF8,
+//  on an ASCII and on a multilingual corpus, in MB/s of UTF-8 text.
+//  Usage: bin/benchstrings [size in MB]
+
+#include "lispe.h"
+#include "benchtools.h"
+
+typedef enum {m_lower, m_upper, m_deaccentuate, m_alpha, m_vowel, m_consonant, m_punctuation, m_emoji} bench_method;
+
+static long apply(Chaine_UTF8* utf8, bench_method m, vector<u_ustring>& lines) {
+    long count = 0;
+    for (auto& l : lines) {
+        switch (m) {
+            case m_lower:
+                count += utf8->u_to_lower(l).size();
+                break;
+            case m_upper:
+                count += utf8->u_to_upper(l).size();
+                break;
+            case m_deaccentuate:
+                count += utf8->s_deaccentuate(l).size();
+                break;
+            case m_alpha:
+                for (long i = 0; i < l.size(); i++)
+                    count += (utf8->c_is_alpha(l[i]) != 0);
+                break;
+            case m_vowel:
+                for (long i = 0; i < l.size(); i++)
+                    count += utf8->c_is_vowel(l[i]);
+                break;
+            case m_consonant:
+                for (long i = 0; i < l.size(); i++)
+                    count += utf8->c_is_consonant(l[i]);
+                break;
+            case m_punctuation:
+                for (long i = 0; i < l.size(); i++)
+                    count += utf8->c_is_punctuation(l[i]);
+                break;
+            case m_emoji:
+                for (long i = 0; i < l.size(); i++)
+                    count += utf8->c_is_emoji(l[i]);
+                break;
+        }
+    }
+    return count;
+}
+
+static void lines_of(string& corpus, vector<u_ustring>& lines) {
+    u_ustring text;
+    s_utf8_to_unicode(text, (unsigned char*)corpus.c_str(), corpus.size());
+    long b = 0;
+    for (long i = 0; i < text.size(); i++) {
+        if (text[i] == '\n') {
+            lines.push_back(text.substr(b, i - b));
+            b = i + 1;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    long size = 4;
+    if (argc > 1)
+        size = atol(argv[1]);
+    if (size <= 0)
+        size = 4;
+
+    LispE lisp;
+    Chaine_UTF8* utf8 = lisp.handlingutf8;
+
+    string ascii = bench_corpus(size << 20, false);
+    string multilingual = bench_corpus(size << 20, true);
+    vector<u_ustring> ascii_lines;
+    vector<u_ustring> multilingual_lines;
+    lines_of(ascii, ascii_lines);
+    lines_of(multilingual, multilingual_lines);
+
+    const char* names[] = {"lower", "upper", "deaccentuate", "is_alpha", "is_vowel", "is_consonant", "is_punctuation", "is_emoji"};
+
+    printf("MB/s of UTF-8 text, %.2f MB per corpus\n\n", ascii.size() / 1048576.0);
+    printf("%-16s %12s %12s %14s\n", "method", "count", "ascii", "multilingual");
+    for (long m = m_lower; m <= m_emoji; m++) {
+        long count = 0;
+        double a = bench_time([&]() {count = apply(utf8, (bench_method)m, ascii_lines);});
+        double w = bench_time([&]() {apply(utf8, (bench_method)m, multilingual_lines);});
+        printf("%-16s %12ld %12.2f %14.2f\n", names[m], count, bench_mbs(ascii.size(), a), bench_mbs(multilingual.size(), w));
+    }
+}
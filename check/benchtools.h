@@ -0,0 +1,84 @@
+/*
+ *  LispE
+ *
+ * Copyright 2020-present NAVER Corp.
+ * The 3-Clause BSD License
+ */
+//  benchtools.h
+//
+//  Helpers shared by the benchmark programs in check/ (make check)
+
+#ifndef benchtools_h
+#define benchtools_h
+
+#include <chrono>
+#include <string>
+#include <stdio.h>
+
+//Returns the best time in milliseconds over 'rounds' calls to f
+template <class F> double bench_time(F f, long rounds = 3) {
+    double best = -1;
+    for (long r = 0; r < rounds; r++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        f();
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (best < 0 || ms < best)
+            best = ms;
+    }
+    return best;
+}
+
+static inline double bench_mbs(double bytes, double ms) {
+    if (ms <= 0)
+        return 0;
+    return (bytes / 1048576.0) / (ms / 1000.0);
+}
+
+//Deterministic pseudo-random generator, so that every run works on the same corpus
+class bench_random {
+public:
+    unsigned long long seed;
+
+    bench_random(unsigned long long s = 88172645463325252ULL) : seed(s) {}
+
+    long next(long n) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return (long)(seed % (unsigned long long)n);
+    }
+};
+
+//A log-like UTF-8 corpus of at least 'size' bytes, one record per line.
+//When 'multilingual' is true, lines also contain accented latin, CJK and emoji characters
+static std::string bench_corpus(long size, bool multilingual) {
+    static const char* levels[] = {"INFO", "DEBUG", "WARNING", "ERROR"};
+    static const char* words[] = {"request", "served", "from", "cache", "user", "session", "opened",
+        "closed", "timeout", "while", "reading", "the", "socket", "payload", "retry", "scheduled"};
+    static const char* others[] = {"café", "déjà", "naïve", "Größe", "東京", "数据库", "서울", "😀", "🚀", "Привет"};
+
+    bench_random rnd;
+    std::string corpus;
+    char buffer[100];
+    while (corpus.size() < size) {
+        sprintf(buffer, "2023-%02ld-%02ld %02ld:%02ld:%02ld ", rnd.next(12) + 1, rnd.next(28) + 1, rnd.next(24), rnd.next(60), rnd.next(60));
+        corpus += buffer;
+        corpus += levels[rnd.next(4)];
+        sprintf(buffer, " user_id=%ld ", rnd.next(100000));
+        corpus += buffer;
+        long nb = 6 + rnd.next(10);
+        for (long i = 0; i < nb; i++) {
+            if (multilingual && !rnd.next(4))
+                corpus += others[rnd.next(10)];
+            else
+                corpus += words[rnd.next(16)];
+            corpus += " ";
+        }
+        sprintf(buffer, "(%ld ms)\n", rnd.next(5000));
+        corpus += buffer;
+    }
+    return corpus;
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ *  LispE
+ *
+ * Copyright 2020-present NAVER Corp.
+ * The 3-Clause BSD License
+ */
+//  benchutf8.cxx
+//
+//  Throughput of the UTF-8 transcoding helpers (s_utf8_to_unicode, s_unicode_to_utf8)
+//  on ASCII, mixed and CJK/emoji texts, compared with a character by character conversion.
+//  Usage: bin/benchutf8 [size in MB]
+
+#include "lispe.h"
+#include "benchtools.h"
+
+unsigned char c_unicode_to_utf8(UWCHAR code, unsigned char* utf);
+
+//The reference conversions: one character at a time, appended to the result
+static void scalar_decode(u_ustring& s, unsigned char* str, long sz) {
+    s = U"";
+    UWCHAR code;
+    for (long i = 0; i < sz; i++) {
+        i += c_utf8_to_unicode(str + i, code);
+        s += code;
+    }
+}
+
+static void scalar_encode(string& s, u_ustring& str) {
+    s = "";
+    unsigned char utf[5];
+    for (long i = 0; i < str.size(); i++) {
+        c_unicode_to_utf8(str[i], utf);
+        s += (char*)utf;
+    }
+}
+
+static void measure(const char* label, string& text) {
+    unsigned char* str = (unsigned char*)text.c_str();
+    long sz = text.size();
+    u_ustring reference, decoded;
+    string encoded_reference, encoded;
+
+    double scalar_dec = bench_time([&]() {scalar_decode(reference, str, sz);});
+    double fast_dec = bench_time([&]() {decoded = U""; s_utf8_to_unicode(decoded, str, sz);});
+    double scalar_enc = bench_time([&]() {scalar_encode(encoded_reference, reference);});
+    double fast_enc = bench_time([&]() {encoded = ""; s_unicode_to_utf8(encoded, decoded);});
+
+    if (reference != decoded)
+        printf("%-10s decoding mismatch\n", label);
+    if (encoded_reference != encoded || encoded != text)
+        printf("%-10s encoding mismatch\n", label);
+
+    printf("%-10s %-7s %12.2f %12.2f %8.2f\n", label, "decode", bench_mbs(sz, scalar_dec), bench_mbs(sz, fast_dec), fast_dec ? scalar_dec / fast_dec : 0);
+    printf("%-10s %-7s %12.2f %12.2f %8.2f\n", label, "encode", bench_mbs(sz, scalar_enc), bench_mbs(sz, fast_enc), fast_enc ? scalar_enc / fast_enc : 0);
+}
+
+int main(int argc, char *argv[]) {
+    long size = 4;
+    if (argc > 1)
+        size = atol(argv[1]);
+    if (size <= 0)
+        size = 4;
+    size <<= 20;
+
+    string ascii = bench_corpus(size, false);
+    string mixed = bench_corpus(size, true);
+
+    //Mostly multi-byte characters: CJK, hangul, cyrillic and emoji, with ASCII spaces
+    static const char* others[] = {"東京", "数据库", "서울", "😀", "🚀", "Привет", "日本語の文章", "👍🏽"};
+    bench_random rnd;
+    string cjk;
+    while (cjk.size() < size) {
+        cjk += others[rnd.next(8)];
+        cjk += " ";
+    }
+
+    printf("MB/s of UTF-8 text, %.2f MB per corpus\n\n", size / 1048576.0);
+    printf("%-10s %-7s %12s %12s %8s\n", "corpus", "", "scalar", "lispe", "speedup");
+    measure("ascii", ascii);
+    measure("mixed", mixed);
+    measure("cjk/emoji", cjk);
+}
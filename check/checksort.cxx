@@ -0,0 +1,111 @@
+/*
+ *  LispE
+ *
+ * Copyright 2020-present NAVER Corp.
+ * The 3-Clause BSD License
+ */
+//  checksort.cxx
+//
+//  Regression checks for sort: the parallel sorting of large typed containers, which is
+//  forced here into several slices whatever the number of hardware threads, and the
+//  non-strict comparators '<= and '>=
+//  Returns a non-zero value if one of the checks fails
+
+#include "lispe.h"
+#include "benchtools.h"
+#include <algorithm>
+
+static long failures = 0;
+
+static void checking(bool test, const char* label) {
+    if (!test) {
+        printf("FAILED: %s\n", label);
+        failures++;
+    }
+}
+
+//Above sort_threading values (see lists.cxx), the slices are sorted in parallel
+const long nbvalues = (1 << 20) + 17;
+
+//sorted holds the values in ascending order
+template <class C, class Z> static void sorting(LispE& lisp, C* container, vector<Z>& values, vector<Z>& sorted, bool descending, const char* label) {
+    container->liste.clear();
+    for (auto& v : values)
+        container->liste.push_back(v);
+
+    List complist;
+    complist.append(lisp.provideAtom(descending?l_greater:l_lower));
+    complist.append(lisp.n_null);
+    complist.append(lisp.n_null);
+    container->sorting(&lisp, &complist, false);
+
+    long sz = sorted.size();
+    bool same = (container->liste.size() == sz);
+    for (long i = 0; same && i < sz; i++)
+        same = (container->liste[i] == sorted[descending?sz - 1 - i:i]);
+    checking(same, label);
+}
+
+static void evaluating(LispE& lisp, string code, string expected) {
+    Element* e = lisp.execute(code);
+    string result = e->toString(&lisp);
+    e->release();
+    if (result != expected)
+        printf("%s: %s instead of %s\n", code.c_str(), result.c_str(), expected.c_str());
+    checking(result == expected, code.c_str());
+}
+
+int main(int argc, char *argv[]) {
+    LispE lisp;
+    bench_random rnd;
+
+    vector<double> numbers;
+    vector<long> integers;
+    vector<u_ustring> strings;
+    char buffer[30];
+    for (long i = 0; i < nbvalues; i++) {
+        integers.push_back(rnd.next(nbvalues) - (nbvalues >> 1));
+        numbers.push_back(integers.back() / 7.0);
+        sprintf(buffer, "%ld", rnd.next(nbvalues));
+        u_ustring u;
+        s_utf8_to_unicode(u, (unsigned char*)buffer, strlen(buffer));
+        strings.push_back(u);
+    }
+
+    vector<double> sorted_numbers = numbers;
+    vector<long> sorted_integers = integers;
+    vector<u_ustring> sorted_strings = strings;
+    std::sort(sorted_numbers.begin(), sorted_numbers.end());
+    std::sort(sorted_integers.begin(), sorted_integers.end());
+    std::sort(sorted_strings.begin(), sorted_strings.end());
+
+    //An odd and an even number of slices: the last slice is either merged or carried over
+    Numbers* n = lisp.provideNumbers();
+    Integers* i = lisp.provideIntegers();
+    Strings* s = lisp.provideStrings();
+    sort_slices = 3;
+    sorting(lisp, n, numbers, sorted_numbers, false, "numbers '<, 3 slices");
+    sorting(lisp, n, numbers, sorted_numbers, true, "numbers '>, 3 slices");
+    sorting(lisp, i, integers, sorted_integers, false, "integers '<, 3 slices");
+    sorting(lisp, s, strings, sorted_strings, false, "strings '<, 3 slices");
+    sort_slices = 4;
+    sorting(lisp, n, numbers, sorted_numbers, false, "numbers '<, 4 slices");
+    sorting(lisp, i, integers, sorted_integers, true, "integers '>, 4 slices");
+    sorting(lisp, s, strings, sorted_strings, false, "strings '<, 4 slices");
+    n->release();
+    i->release();
+    s->release();
+    sort_slices = 0;
+
+    //'<= and '>= are handled as '< and '>
+    evaluating(lisp, "(sort '<= (numbers 3 1 2 1))", "(1 1 2 3)");
+    evaluating(lisp, "(sort '>= (integers 3 1 2 1))", "(3 2 1 1)");
+    evaluating(lisp, "(sort '>= (strings \"b\" \"a\" \"c\"))", "(\"c\" \"b\" \"a\")");
+    evaluating(lisp, "(sort '<= '(3 1 2 1))", "(1 1 2 3)");
+    evaluating(lisp, "(sort '>= '(3 1 2 1) true)", "(3 2 1 1)");
+    evaluating(lisp, "(sort (lambda (x y) (< x y)) '(3 1 2 1))", "(1 1 2 3)");
+
+    if (!failures)
+        printf("sort: all checks passed\n");
+    return failures != 0;
+}
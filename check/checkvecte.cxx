@@ -0,0 +1,93 @@
+/*
+ *  LispE
+ *
+ * Copyright 2020-present NAVER Corp.
+ * The 3-Clause BSD License
+ */
+//  checkvecte.cxx
+//
+//  Regression checks for the shared buffers of vecte_a and vecte_n (copy-on-write views)
+//  Returns a non-zero value if one of the checks fails
+
+#include "lispe.h"
+
+static long failures = 0;
+
+static void checking(bool test, const char* label) {
+    if (!test) {
+        printf("FAILED: %s\n", label);
+        failures++;
+    }
+}
+
+template <class Z> static bool same(vecte_a<Z>& v, vector<Z> values) {
+    if (v.size() != values.size())
+        return false;
+    for (long i = 0; i < v.size(); i++) {
+        if (v[i] != values[i])
+            return false;
+    }
+    return true;
+}
+
+template <class Z> static bool same(vecte_n<Z>& v, vector<Z> values) {
+    if (v.size() != values.size())
+        return false;
+    for (long i = 0; i < v.size(); i++) {
+        if (v[i] != values[i])
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    vecte_a<double> base;
+    for (long i = 0; i < 10; i++)
+        base.push_back(i);
+
+    //A view of a view: the offset is relative to the view it is taken from
+    vecte_a<double> view(base, 2);
+    vecte_a<double> other;
+    other.share(base, 0);
+    other.share(view, 3);
+    checking(same(other, {5, 6, 7, 8, 9}), "share: view of a view");
+    view.share(view, 1);
+    checking(same(view, {3, 4, 5, 6, 7, 8, 9}), "share: view of itself");
+
+    //Assignment between two views of the same buffer
+    vecte_a<double> first(base, 3);
+    vecte_a<double> second(base, 5);
+    first = second;
+    checking(same(first, {5, 6, 7, 8, 9}), "operator=: views of the same buffer");
+    checking(same(base, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), "operator=: shared buffer is unchanged");
+
+    //Writing into a view leaves the other vectors untouched
+    vecte_a<double> suffix(base, 1);
+    suffix.put(0, 100);
+    checking(same(suffix, {100, 2, 3, 4, 5, 6, 7, 8, 9}), "put: view is modified");
+    checking(base[1] == 1, "put: parent is unchanged");
+
+    //Strings
+    vecte_n<u_ustring> strings;
+    strings.push_back(U"a");
+    strings.push_back(U"z");
+    strings.push_back(U"x");
+    strings.push_back(U"y");
+    vecte_n<u_ustring> tail(strings, 1);
+    vecte_n<u_ustring> tail_of_tail;
+    tail_of_tail.share(tail, 1);
+    checking(same(tail_of_tail, {U"x", U"y"}), "vecte_n share: view of a view");
+    tail.detach();
+    tail.swap(0, 2);
+    checking(same(tail, {U"y", U"x", U"z"}), "vecte_n swap: view is modified");
+    checking(same(strings, {U"a", U"z", U"x", U"y"}), "vecte_n swap: parent is unchanged");
+    tail_of_tail.push_back(U"w");
+    checking(same(strings, {U"a", U"z", U"x", U"y"}), "vecte_n push_back: parent is unchanged");
+    vecte_n<u_ustring> copy(strings, 0);
+    copy = tail_of_tail;
+    checking(same(copy, {U"x", U"y", U"w"}), "vecte_n operator=");
+
+    if (!failures)
+        printf("vecte: all checks passed\n");
+    return failures != 0;
+}
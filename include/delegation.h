@@ -341,15 +341,13 @@ public:
     }
 
     short encode(u_ustring& s) {
-        try {
-            return string_to_code.at(s);
-        }
-        catch (...) {
-            long idx = string_to_code.size() + l_final;
-            code_to_string[idx] = s;
-            string_to_code[s] = idx;
-            return idx;
-        }
+        auto it = string_to_code.find(s);
+        if (it != string_to_code.end())
+            return it->second;
+        long idx = string_to_code.size() + l_final;
+        code_to_string[idx] = s;
+        string_to_code[s] = idx;
+        return idx;
     }
     
     short encode(wchar_t c) {
@@ -390,37 +388,27 @@ public:
     lisp_code check_atom(string& w) {
         u_ustring s;
         s_utf8_to_unicode(s, USTR(w), w.size());
-        try {
-            short code = string_to_code.at(s);
-            if (atom_pool.check(code))
-                return (lisp_code)code;
-        }
-        catch (...) {
-        }
+        return check_atom(s);
+    }
+
+    //Most atoms in a source file are unknown, hence find rather than at and an exception
+    lisp_code check_atom(u_ustring& s) {
+        auto it = string_to_code.find(s);
+        if (it != string_to_code.end() && atom_pool.check(it->second))
+            return (lisp_code)it->second;
         return l_final;
     }
 
     short is_atom(string& w) {
         u_ustring s;
         s_utf8_to_unicode(s, USTR(w), w.size());
-        try {
-            short code = string_to_code.at(s);
-            if (atom_pool.check(code))
-                return code;
-        }
-        catch (...) {
-        }
-        return -1;
+        return is_atom(s);
     }
 
     short is_atom(u_ustring& s) {
-        try {
-            short code = string_to_code.at(s);
-            if (atom_pool.check(code))
-                return code;
-        }
-        catch (...) {
-        }
+        auto it = string_to_code.find(s);
+        if (it != string_to_code.end() && atom_pool.check(it->second))
+            return it->second;
         return -1;
     }
 
@@ -83,7 +83,7 @@ typedef enum {
     
     l_innerproduct, l_matrix, l_tensor, l_matrix_float, l_tensor_float, l_outerproduct, l_factorial, l_iota, l_iota0,
     l_reduce, l_scan, l_backreduce, l_backscan, l_rho, l_rank, l_irank,
-    l_member, l_transpose, l_invert, l_determinant, l_solve, l_ludcmp, l_lubksb,
+    l_member, l_transpose, l_invert, l_determinant, l_solve, l_ludcmp, l_lubksb, l_cholesky, l_qr,
     
     //Comparisons
         
@@ -696,6 +696,20 @@ public:
     virtual bool is_cyclic() {
         return false;
     }
+
+    //Cycle collection (see LispE::collect_cycles)
+    //Only pooled lists, dictionaries and sets, and linked lists take part in it
+    virtual bool isCollectable() {
+        return false;
+    }
+    
+    virtual void collectable_children(vector<Element*>& children) {}
+    
+    //nodes associates each visited container with 0 if it is garbage
+    //Returns the approximate number of bytes that were reclaimed
+    virtual long collect(std::unordered_map<Element*, long>& nodes) {
+        return 0;
+    }
     
     virtual Element* cadr(LispE*,Element*);
     virtual Element* car(LispE*);
@@ -2800,6 +2814,17 @@ public:
 
     void decrementstatus(uint16_t nb);
     void decrement();
+
+    bool isCollectable() {
+        return !is_protected();
+    }
+    
+    void collectable_children(vector<Element*>& children) {
+        for (auto& a : dictionary)
+            children.push_back(a.second);
+    }
+    
+    long collect(std::unordered_map<Element*, long>& nodes);
     
     void release();
     Element* fullcopy();
@@ -3236,6 +3261,17 @@ public:
 
     void decrementstatus(uint16_t nb);
     void decrement();
+
+    bool isCollectable() {
+        return !is_protected();
+    }
+    
+    void collectable_children(vector<Element*>& children) {
+        for (auto& a : dictionary)
+            children.push_back(a.second);
+    }
+    
+    long collect(std::unordered_map<Element*, long>& nodes);
     
     void release();
     Element* fullcopy();
@@ -3643,6 +3679,17 @@ public:
 
     void decrementstatus(uint16_t nb);
     void decrement();
+
+    bool isCollectable() {
+        return !is_protected();
+    }
+    
+    void collectable_children(vector<Element*>& children) {
+        for (auto& a : dictionary)
+            children.push_back(a.second);
+    }
+    
+    long collect(std::unordered_map<Element*, long>& nodes);
     
     void release();
     Element* fullcopy();
@@ -5034,6 +5081,17 @@ public:
     void decrementstatus(uint16_t nb);
     void decrement();
     
+    bool isCollectable() {
+        return !is_protected();
+    }
+    
+    void collectable_children(vector<Element*>& children) {
+        for (auto& a : dictionary)
+            children.push_back(a.second);
+    }
+    
+    long collect(std::unordered_map<Element*, long>& nodes);
+    
     void release();
     Element* fullcopy();
     Element* copying(bool duplicate = true);
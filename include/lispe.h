@@ -19,6 +19,7 @@
 #include "stack.h"
 #include "delegation.h"
 #include <stack>
+#include <unordered_set>
 
 //------------------------------------------------------------
 #define debug_none 0
@@ -40,6 +41,21 @@ class LispE {
 
     vecte<Stackelement*> execution_stack;
     long max_stack_size;
+    //Maximum number of elements kept in each pool
+    //when trimming at the end of an execution (-1 means no limit)
+    long max_pool_size;
+    //The same limit for a given pool, which replaces max_pool_size for this pool
+    std::unordered_map<u_ustring, long> max_pool_sizes;
+
+    //Cycle collection: pooled lists, dictionaries and sets, whose reference counter
+    //was decremented without reaching 0, are candidates (see LispE::collect_cycles)
+    std::unordered_set<Element*> cycle_candidates;
+    //-1: no cycle collection, otherwise the number of candidates
+    //that triggers a collection at the end of an execution
+    long cycle_threshold;
+    //Number of load/execute currently running: cycles can only be
+    //collected at the end of the outermost one, when no C++ temporaries are alive
+    long execution_depth;
 
 public:
     Element* _BOOLEANS[2];
@@ -89,6 +105,14 @@ public:
     List* void_function;
     LispE* thread_ancestor;
     
+    //Cycle collection statistics
+    long cycle_runs;
+    long cycle_reclaimed;
+    long cycle_bytes;
+    long cycle_last_reclaimed;
+    long cycle_last_bytes;
+    double cycle_pause;
+
     Element* n_null;
     Element* n_true;
     Element* n_zero;
@@ -112,6 +136,15 @@ public:
         evaluating = false;
         id_thread = 0;
         max_stack_size = 10000;
+        max_pool_size = -1;
+        cycle_threshold = -1;
+        execution_depth = 0;
+        cycle_runs = 0;
+        cycle_reclaimed = 0;
+        cycle_bytes = 0;
+        cycle_last_reclaimed = 0;
+        cycle_last_bytes = 0;
+        cycle_pause = 0;
         trace = debug_none;
         delegation = new Delegation;
         isThread = false;
@@ -440,6 +473,61 @@ public:
             return;
         max_stack_size = m;
     }
+
+    long pool_size_max() {
+        return max_pool_size;
+    }
+
+    long pool_size_max(u_ustring pool) {
+        auto it = max_pool_sizes.find(pool);
+        return (it == max_pool_sizes.end())?max_pool_size:it->second;
+    }
+
+    void set_pool_max_size(long m) {
+        max_pool_size = (m < 0)?-1:m;
+    }
+    
+    void set_pool_max_size(long m, u_ustring pool) {
+        max_pool_sizes[pool] = (m < 0)?-1:m;
+    }
+    
+    //We give back to the system the pooled elements beyond max_pool_size
+    //or beyond the limit of each pool
+    inline void trimming_pools() {
+        if (max_pool_size != -1 || max_pool_sizes.size())
+            trim_pools(max_pool_size, NULL, true);
+    }
+    
+    long trim_pools(long nb, Dictionary* d = NULL, bool limits = false);
+    Element* pool_sizes();
+
+    inline void cycle_candidate(Element* e) {
+        if (cycle_threshold != -1)
+            cycle_candidates.insert(e);
+    }
+
+    long cycle_collection_threshold() {
+        return cycle_threshold;
+    }
+
+    void set_cycle_collection_threshold(long m) {
+        cycle_threshold = (m < 0)?-1:m;
+        if (cycle_threshold == -1)
+            cycle_candidates.clear();
+    }
+
+    //result is the value returned by the outermost execution, it is protected
+    //during the collection
+    inline void collecting_cycles(Element* result) {
+        if (!execution_depth && cycle_threshold != -1 && cycle_candidates.size() >= cycle_threshold) {
+            result->increment();
+            collect_cycles();
+            result->decrementkeep();
+        }
+    }
+    
+    long collect_cycles();
+    Element* cycle_statistics();
     
     inline void stop() {
         delegation->stop_execution = 0x100;
@@ -1005,36 +1093,30 @@ public:
     }
 
     inline String* provideConststring(u_ustring& u) {
-        try {
-            return const_string_pool.at(u);
-        }
-        catch(...) {
-            Conststring* c = new Conststring(u);
-            const_string_pool[u] = c;
-            return c;
-        }
+        auto it = const_string_pool.find(u);
+        if (it != const_string_pool.end())
+            return it->second;
+        Conststring* c = new Conststring(u);
+        const_string_pool[u] = c;
+        return c;
     }
 
     inline Integer* provideConstinteger(long u) {
-        try {
-            return const_integer_pool.at(u);
-        }
-        catch(...) {
-            Constinteger* c = new Constinteger(u);
-            const_integer_pool[u] = c;
-            return c;
-        }
+        auto it = const_integer_pool.find(u);
+        if (it != const_integer_pool.end())
+            return it->second;
+        Constinteger* c = new Constinteger(u);
+        const_integer_pool[u] = c;
+        return c;
     }
 
     inline Number* provideConstnumber(double u) {
-        try {
-            return const_number_pool.at(u);
-        }
-        catch(...) {
-            Constnumber* c = new Constnumber(u);
-            const_number_pool[u] = c;
-            return c;
-        }
+        auto it = const_number_pool.find(u);
+        if (it != const_number_pool.end())
+            return it->second;
+        Constnumber* c = new Constnumber(u);
+        const_number_pool[u] = c;
+        return c;
     }
 
     inline List* provideList() {
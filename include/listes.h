@@ -18,6 +18,9 @@
 
 typedef Element* (List::*methodEval)(LispE*);
 
+//see native_sorting in lists.cxx
+extern long sort_slices;
+
 class Matrice;
 
 class Atomefonction : public Element {
@@ -362,8 +365,11 @@ public:
     }
     
     bool compare(LispE*, List* compare, short instruction, long i, long j);
-    void sorting(LispE*, List* f, short instruction, long b, long e);
-    void sorting(LispE*, List* f);
+    void sorting(LispE*, List* f, short instruction, long b, long e, long depth);
+    void sifting(LispE*, List* f, short instruction, long base, long root, long nb);
+    void heap_sorting(LispE*, List* f, short instruction, long b, long e);
+    void stable_sorting(LispE*, List* f, short instruction, long b, long e, Element** buffer);
+    void sorting(LispE*, List* f, bool stable = false);
     
     void operator =(LIST& z) {
         item->last = home;
@@ -1186,6 +1192,7 @@ public:
     Element* evall_cdr(LispE* lisp);
     Element* evall_check(LispE* lisp);
     Element* evall_checking(LispE* lisp);
+    Element* evall_cholesky(LispE* lisp);
     Element* evall_compose(LispE* lisp);
     Element* evall_concatenate(LispE* lisp);
     Element* evall_cond(LispE* lisp);
@@ -1323,6 +1330,7 @@ public:
     Element* evall_printerrln(LispE* lisp);
     Element* evall_println(LispE* lisp);
     Element* evall_product(LispE* lisp);
+    Element* evall_qr(LispE* lisp);
     Element* evall_push(LispE* lisp);
     Element* evall_pushfirst(LispE* lisp);
     Element* evall_pushlast(LispE* lisp);
@@ -1470,6 +1478,17 @@ public:
     Element* copyatom(LispE* lisp, uint16_t s);
     Element* copying(bool duplicate = true);
 
+    //A list whose buffer is shared through cdr cannot be collected
+    bool isCollectable() {
+        return (!is_protected() && liste.nocdr());
+    }
+    
+    void collectable_children(vector<Element*>& children) {
+        for (long i = 0; i < liste.size(); i++)
+            children.push_back(liste[i]);
+    }
+    
+    long collect(std::unordered_map<Element*, long>& nodes);
 };
 
 class Listargumentquote : public List {
@@ -1737,6 +1756,28 @@ public:
 };
 
 
+//Arithmetic expressions such as: (+ (* a b) (* c d) e), whose leaves are variables or numbers
+//When the leaves are numbers containers of the same size (or single values),
+//the expression is computed chunk by chunk in one single pass, without intermediate containers
+class List_fused_arithmetic : public List {
+public:
+    long nb_leaves;
+    
+    List_fused_arithmetic(List* l) : List(l, 0) {
+        nb_leaves = 0;
+        counting_leaves(this);
+    }
+    
+    static bool operation(Element* e);
+    static bool fusable(Element* e);
+    
+    void counting_leaves(Element* e);
+    char checking(Element* e, Element** values, long& pos, long& sz);
+    void computing(Element* e, Element** values, long& pos, long first, long nb, double* result);
+    Element* evaluating(LispE* lisp, Element* e, Element** values, long& pos);
+    Element* eval(LispE*);
+};
+
 class List_power2 : public List {
 public:
     List_power2(List* l) : List(l, 0) {}
@@ -2227,7 +2268,7 @@ public:
     Element* divide_direct(LispE* lisp, Element* e);
 
 
-    void sorting(LispE* lisp, List* comparison);
+    void sorting(LispE* lisp, List* comparison, bool stable = false);
 };
 
 
@@ -2249,15 +2290,23 @@ public:
         exchange_value.provide = true;
     }
 
-    Floatspool(LispE* l, Floats* f, long pos) : lisp(l), Floats(f, pos) {
+    //A suffix of f (cdr): the buffer of f is shared until one of them is modified
+    //(copy-on-write, see vecte_a::detach). Constants can be read by several threads
+    //at once, their buffer is copied, since the reference counter is not atomic.
+    Floatspool(LispE* l, Floats* f, long pos) : lisp(l) {
+        if (f->is_protected())
+            liste.copy_from(f->liste, pos);
+        else
+            liste.share(f->liste, pos);
         exchange_value.lisp = l;
         exchange_value.provide = true;
     }
     
     inline Floatspool* set(Floats* nb, long pos) {
-        liste.clear();
-        for (long i = pos; i < nb->liste.size(); i++)
-            liste.push_back(nb->liste[i]);
+        if (nb->is_protected())
+            liste.copy_from(nb->liste, pos);
+        else
+            liste.share(nb->liste, pos);
         return this;
     }
 
@@ -2687,7 +2736,7 @@ public:
     Element* divide_direct(LispE* lisp, Element* e);
 
 
-    void sorting(LispE* lisp, List* comparison);
+    void sorting(LispE* lisp, List* comparison, bool stable = false);
 };
 
 class Numberspool : public Numbers {
@@ -2708,16 +2757,24 @@ public:
         exchange_value.provide = true;
     }
 
-    Numberspool(LispE* l, Numbers* f, long pos) : lisp(l), Numbers(f, pos) {
+    //A suffix of f (cdr): the buffer of f is shared until one of them is modified
+    //(copy-on-write, see vecte_a::detach). Constants can be read by several threads
+    //at once, their buffer is copied, since the reference counter is not atomic.
+    Numberspool(LispE* l, Numbers* f, long pos) : lisp(l) {
+        if (f->is_protected())
+            liste.copy_from(f->liste, pos);
+        else
+            liste.share(f->liste, pos);
         exchange_value.lisp = l;
         exchange_value.provide = true;
     }
     
 
     inline Numberspool* set(Numbers* nb, long pos) {
-        liste.clear();
-        for (long i = pos; i < nb->liste.size(); i++)
-            liste.push_back(nb->liste[i]);
+        if (nb->is_protected())
+            liste.copy_from(nb->liste, pos);
+        else
+            liste.share(nb->liste, pos);
         return this;
     }
 
@@ -3126,8 +3183,11 @@ public:
     }
     
     virtual Element* copyatom(LispE* lisp, uint16_t s) {
-        if (liste.shared(status) < s)
+        if (liste.shared(status) < s) {
+            //The values are going to be modified in place
+            liste.detach();
             return this;
+        }
 
         Shorts* i = new Shorts(this);
         release();
@@ -3154,7 +3214,7 @@ public:
     Element* multiply_direct(LispE* lisp, Element* e);
     Element* divide_direct(LispE* lisp, Element* e);
 
-    void sorting(LispE* lisp, List* comparison);
+    void sorting(LispE* lisp, List* comparison, bool stable = false);
 };
 
 class Integers : public Element {
@@ -3554,7 +3614,7 @@ public:
     Element* multiply_direct(LispE* lisp, Element* e);
     Element* divide_direct(LispE* lisp, Element* e);
 
-    void sorting(LispE* lisp, List* comparison);
+    void sorting(LispE* lisp, List* comparison, bool stable = false);
 };
 
 class Integerspool : public Integers {
@@ -3575,15 +3635,23 @@ public:
         exchange_value.provide = true;
     }
 
-    Integerspool(LispE* l, Integers* f, long pos) : lisp(l), Integers(f, pos) {
+    //A suffix of f (cdr): the buffer of f is shared until one of them is modified
+    //(copy-on-write, see vecte_a::detach). Constants can be read by several threads
+    //at once, their buffer is copied, since the reference counter is not atomic.
+    Integerspool(LispE* l, Integers* f, long pos) : lisp(l) {
+        if (f->is_protected())
+            liste.copy_from(f->liste, pos);
+        else
+            liste.share(f->liste, pos);
         exchange_value.lisp = l;
         exchange_value.provide = true;
     }
     
     inline Integerspool* set(Integers* nb, long pos) {
-        liste.clear();
-        for (long i = pos; i < nb->liste.size(); i++)
-            liste.push_back(nb->liste[i]);
+        if (nb->is_protected())
+            liste.copy_from(nb->liste, pos);
+        else
+            liste.share(nb->liste, pos);
         return this;
     }
 
@@ -3657,6 +3725,11 @@ public:
     Matrice_float(LispE* lisp, long x, long y, float n);
     Matrice_float(LispE* lisp, Matrice_float* m);
     Matrice_float(LispE* lisp, Matrice* m);
+    //The rows are copied from a dense matrix or one of its views
+    Matrice_float(LispE* lisp, dense_matrix<float>& m);
+
+    //We copy the rows into a dense matrix, in one single buffer
+    void dense(dense_matrix<float>& m);
 
     //We steal the ITEM structure of this list
     Matrice_float(List* l) : List(l,0) {
@@ -3836,6 +3909,11 @@ public:
     Matrice(LispE* lisp, long x, long y, double n);
     Matrice(LispE* lisp, Matrice* m);
     Matrice(LispE* lisp, Matrice_float* m);
+    //The rows are copied from a dense matrix or one of its views
+    Matrice(LispE* lisp, dense_matrix<double>& m);
+
+    //We copy the rows into a dense matrix, in one single buffer
+    void dense(dense_matrix<double>& m);
 
     //We steal the ITEM structure of this list
     Matrice(List* l) : List(l,0) {
@@ -3903,6 +3981,8 @@ public:
     double determinant();
     Element* ludcmp(LispE* lisp);
     Element* lubksb(LispE* lisp, Integers* indexes, Matrice* Y = NULL);
+    Element* cholesky(LispE* lisp, Matrice* Y = NULL);
+    Element* qr(LispE* lisp, Matrice* Y = NULL);
 
     void build(LispE* lisp, Element* lst);
 
@@ -3973,6 +4053,11 @@ public:
 
 };
 
+//(. m1 '+ '* m2) on Matrice or Matrice_float
+//matrix_product can only be called when dense_rows is true for both matrices
+bool dense_rows(Element* m);
+Element* matrix_product(LispE* lisp, Element* m1, Element* m2);
+
 class Tenseur_float : public List {
 public:
     vecte<long> shape;
@@ -4808,15 +4893,15 @@ public:
     }
 
     void change(long i, Element* e) {
-        liste[i] = e->asUString(NULL);
+        liste.put(i, e->asUString(NULL));
     }
 
     void changelast(Element* e) {
-        liste[liste.size()-1] = e->asUString(NULL);
+        liste.put(liste.size()-1, e->asUString(NULL));
     }
     
     void replacing(long i, Element* e) {
-        liste[i] = e->asUString(NULL);
+        liste.put(i, e->asUString(NULL));
     }
     
     Element* replace(LispE* lisp, long i, Element* e) {
@@ -4829,7 +4914,7 @@ public:
         if (i >= liste.size())
             liste.push_back(e->asUString(NULL));
         else {
-            liste[i] = e->asUString(NULL);
+            liste.put(i, e->asUString(NULL));
         }
         return this;
     }
@@ -4918,7 +5003,7 @@ public:
 
     Element* plus(LispE* l, Element* e);
 
-    void sorting(LispE* lisp, List* comparison);
+    void sorting(LispE* lisp, List* comparison, bool stable = false);
 
 };
 
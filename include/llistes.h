@@ -762,6 +762,32 @@ public:
         }
     }
     
+    //Cycle collection (see LispE::collect_cycles)
+    //A linked list has no access to LispE, it cannot register itself as a candidate.
+    //It is visited and reclaimed when it can be reached from a pooled list, dictionary or set.
+    //Links shared with another linked list (cdr) and cyclic links are kept out
+    bool isCollectable() {
+        if (is_protected() || liste.check_cycle())
+            return false;
+        u_link* u = liste.begin();
+        while (u != NULL) {
+            if (u->status != 1)
+                return false;
+            u = u->next();
+        }
+        return true;
+    }
+
+    void collectable_children(vector<Element*>& children) {
+        u_link* u = liste.begin();
+        while (u != NULL) {
+            children.push_back(u->value);
+            u = u->next();
+        }
+    }
+
+    long collect(std::unordered_map<Element*, long>& nodes);
+    
     Element* join_in_list(LispE* lisp, u_ustring& sep);
     
     Element* extraction(LispE* lisp, List*);
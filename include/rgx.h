@@ -272,13 +272,85 @@ public:
 
 };
 
+//------------------------lazy deterministic automaton-------------------------------------------
+//A DFA state is the set of Au_state reached after reading a character (error states are dropped)
+//Transitions are computed on demand and cached. Beyond its limit of states, the DFA is abandoned
+//and the automaton falls back to the Au_state traversal.
+#define au_dfa_limit 1024
+#define au_dfa_set_limit 8192
+#define au_dfa_ascii 128
+
+class Au_dfa_state {
+public:
+    vector<Au_state*> kernel;
+    vector<Au_state*> closure;
+    std::unordered_map<UWCHAR, long> others;
+    vector<long> rules; //automatons (in a set) with an end state in closure
+    vector<long> finals; //automatons (in a set) with an end state in kernel
+    long ascii[au_dfa_ascii];
+    bool final; //a kernel state is an end state
+    bool reachable; //an end state can be reached through epsilon arcs
+    
+    Au_dfa_state(vector<Au_state*>& k) {
+        kernel = k;
+        final = false;
+        reachable = false;
+        for (long i = 0; i < au_dfa_ascii; i++)
+            ascii[i] = -1;
+    }
+};
+
+class Au_dfa {
+public:
+    vector<Au_dfa_state*> states;
+    std::map<vector<Au_state*>, long> indexes;
+    //For a set of automatons: their initial states and the automaton each state belongs to
+    vector<Au_state*> starts;
+    std::unordered_map<Au_state*, long> owners;
+    //Literal prefix shared by all matches, or else the possible first characters
+    u_ustring prefix;
+    u_ustring initials;
+    std::mutex lock;
+    long limit;
+    bool unanchored;
+    bool overflow;
+    bool filtering;
+    
+    Au_dfa(Au_state* first);
+    Au_dfa(vector<Au_automate*>& automatons, bool unanchored);
+    
+    ~Au_dfa() {
+        for (long i = 0; i < states.size(); i++)
+            delete states[i];
+    }
+    
+    long state(vector<Au_state*>& kernel);
+    long transition(long s, UWCHAR c);
+    
+    void prefiltering();
+    long next(u_ustring& w, long i);
+    
+    char match(u_ustring& w);
+    bool possible(u_ustring& w, long i);
+    
+    bool matches(u_ustring& w, vector<char>& found);
+    bool candidates(u_ustring& w, vector<char>& found);
+};
+
 class Au_automaton {
 public:
     
     Au_state* first;
+    Au_dfa* dfa;
     
     Au_automaton() {
         first=NULL;
+        dfa=NULL;
+    }
+    
+    virtual ~Au_automaton() {
+        if (dfa != NULL)
+            delete dfa;
     }
 
     Au_automaton(u_ustring rgx);
@@ -327,6 +399,19 @@ public:
     long find(u_ustring& w);
     long find(u_ustring& w, long i);
 
+    long scan(u_ustring& w, long i);
+    long skip(u_ustring& w, long i) {
+        if (dfa == NULL || !dfa->filtering)
+            return i;
+        return dfa->next(w, i);
+    }
+    void reset() {
+        if (dfa != NULL) {
+            delete dfa;
+            dfa = NULL;
+        }
+    }
+
 
     bool search(u_ustring& w, long& first, long& last, long init = 0);
 
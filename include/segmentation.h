@@ -44,12 +44,27 @@ public:
         positions.clear();
     }
     
+    void reserve(long nb) {
+        tokens.reserve(nb);
+        numbers.reserve(nb);
+        types.reserve(nb);
+        lines.reserve(nb);
+        positions.reserve(nb << 1);
+    }
+    
     void append(uchar car, lisp_code t, long l, long posbeg, long posend) {
-        string token;
-        token = car;
-        u_ustring segment;
-        s_utf8_to_unicode(segment, USTR(token), token.size());
-        tokens.push_back(segment);
+        tokens.push_back(u_ustring(1, (u_uchar)car));
+        numbers.push_back(0);
+        types.push_back(t);
+        lines.push_back(l);
+        positions.push_back(posbeg);
+        positions.push_back(posend);
+    }
+
+    //The token is converted in place, straight from the source buffer
+    void append(unsigned char* token, long sz, lisp_code t, long l, long posbeg, long posend) {
+        tokens.push_back(U"");
+        s_utf8_to_unicode(tokens.back(), token, sz);
         numbers.push_back(0);
         types.push_back(t);
         lines.push_back(l);
@@ -58,9 +73,13 @@ public:
     }
 
     void append(string& token, lisp_code t, long l, long posbeg, long posend) {
-        u_ustring segment;
-        s_utf8_to_unicode(segment, USTR(token), token.size());
-        tokens.push_back(segment);
+        append(USTR(token), token.size(), t, l, posbeg, posend);
+    }
+
+    //The token has already been converted, it is moved into tokens
+    void append(u_ustring& token, lisp_code t, long l, long posbeg, long posend) {
+        tokens.push_back(U"");
+        tokens.back().swap(token);
         numbers.push_back(0);
         types.push_back(t);
         lines.push_back(l);
@@ -68,10 +87,9 @@ public:
         positions.push_back(posend);
     }
 
-    void append(double valeur, string& token, lisp_code t, long l, long posbeg, long posend) {
-        u_ustring segment;
-        s_utf8_to_unicode(segment, USTR(token), token.size());
-        tokens.push_back(segment);
+    void append(double valeur, unsigned char* token, long sz, lisp_code t, long l, long posbeg, long posend) {
+        tokens.push_back(U"");
+        s_utf8_to_unicode(tokens.back(), token, sz);
         numbers.push_back(valeur);
         types.push_back(t);
         lines.push_back(l);
@@ -79,6 +97,10 @@ public:
         positions.push_back(posend);
     }
 
+    void append(double valeur, string& token, lisp_code t, long l, long posbeg, long posend) {
+        append(valeur, USTR(token), token.size(), t, l, posbeg, posend);
+    }
+
 };
 
 
@@ -48,9 +48,15 @@ public:
     vector<vector<short> > ruleelements;
     vector<short*> closing;
     vector<short> action;
+    //for each rule, the precomputed results of check on ASCII characters (128 per element)
+    vector<char*> asciichecks;
 
     vector<long> stackln;
     vecte<long> stacktype;
+    //When packed is set, the tokens are appended to this single buffer instead of the stack
+    //boundaries then receives the end position of each token in packed
+    u_ustring* packed;
+    vecte_a<long>* boundaries;
     //vector<long> cpos;
     
     Chaine_UTF8* access;
@@ -70,10 +76,16 @@ public:
             if (closing[i] != NULL)
                 delete[] closing[i];
         }
+        for (long i = 0; i < asciichecks.size(); i++) {
+            if (asciichecks[i] != NULL)
+                delete[] asciichecks[i];
+        }
     }
 
     x_tokens() {
         access = NULL;
+        packed = NULL;
+        boundaries = NULL;
         firstrule=-1;
         juststack=false;
         loaded=false;
@@ -115,6 +127,11 @@ public:
                 delete[] closing[i];
         }
         closing.clear();
+        for (long i = 0; i < asciichecks.size(); i++) {
+            if (asciichecks[i] != NULL)
+                delete[] asciichecks[i];
+        }
+        asciichecks.clear();
 
         tokenizer.clear();
         disjunctions.clear();
@@ -677,6 +694,36 @@ public:
             }
         }
         rules.clear();
+        compilerules();
+    }
+
+    void compilerules() {
+        /*
+         Each rule element is compiled into a table of 128 values, which stores the result of check
+         for every ASCII character. During tokenization, ASCII characters are then tested with
+         a simple lookup, while other characters fall back on check (Unicode classes, operators etc.)
+         */
+        u_uchar chr[] = {0,0,0};
+        long i, r, sz;
+        u_uchar c;
+        char* tbl;
+        
+        for (i = 0; i < tokenizer.size(); i++) {
+            sz = tokenizer[i].size();
+            if (!sz) {
+                asciichecks.push_back(NULL);
+                continue;
+            }
+            
+            tbl = new char[sz << 7];
+            for (r = 0; r < sz; r++) {
+                for (c = 0; c < 128; c++) {
+                    chr[0] = c;
+                    tbl[(r << 7) + c] = check(tokenizer[i][r], ruleelements[i][r], chr);
+                }
+            }
+            asciichecks.push_back(tbl);
+        }
     }
 
     char check(u_ustring& label, short type, u_uchar* chr) {
@@ -806,6 +853,25 @@ public:
         return false;
     }
     
+    //check on the element r of rule i, with a table lookup for ASCII characters
+    inline char checkrule(short i, short r, u_uchar* chr) {
+        if (chr[0] < 128)
+            return asciichecks[i][(r << 7) + chr[0]];
+        return check(tokenizer[i][r], ruleelements[i][r], chr);
+    }
+    
+    inline void stacking(vecte_n<u_ustring>* vstack, u_uchar* token) {
+        if (packed == NULL) {
+            vstack->push_back(token);
+            return;
+        }
+        long sz = 0;
+        while (token[sz])
+            sz++;
+        packed->append(token, sz);
+        boundaries->push_back(packed->size());
+    }
+    
     void apply(u_ustring& toparse, vecte_n<u_ustring>* vstack);
     char loop(u_ustring& toparse, short i, u_uchar* token, u_uchar* chr, long& itoken, short& r, long& line, long& posc);
 
@@ -867,6 +933,19 @@ public:
         apply(thestr, vstack);
     }
 
+    //The tokens are appended to buffer, without any u_ustring allocation per token
+    //The end position of each token in buffer is pushed into ends
+    void tokenize(u_ustring& thestr, u_ustring& buffer, vecte_a<long>& ends) {
+        if (!juststack) {
+            stackln.clear();
+        }
+        packed = &buffer;
+        boundaries = &ends;
+        apply(thestr, &stack);
+        packed = NULL;
+        boundaries = NULL;
+    }
+
 };
 
 #endif
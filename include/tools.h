@@ -127,6 +127,10 @@ wstring convertToWString(float d);
 string convertToString(float d);
 u_ustring convertToUString(float d);
 
+long u_find(u_ustring& s, u_ustring& sub, long from);
+long u_rfind(u_ustring& s, u_ustring& sub, long from);
+long s_find(string& s, string& sub, long from);
+
 string s_replacingstring(string& s, string reg, string rep);
 wstring s_wreplacestring(wstring& s, wstring reg, wstring rep);
 u_ustring s_ureplacestring(u_ustring& s, u_ustring reg, u_ustring rep);
@@ -197,6 +201,15 @@ public:
     unordered_map<u_uchar, string> emojis;
     unordered_map<u_uchar, bool> emojiscomplement;
 
+    //ASCII characters are handled with direct tables, computed once from the tables above
+    //ascii_properties: 1 lowercase, 2 uppercase (as c_is_alpha), 4 punctuation, 8 vowel, 16 consonant
+    unsigned char ascii_properties[128];
+    u_uchar ascii_lower[128];
+    u_uchar ascii_upper[128];
+    u_uchar ascii_plain[128];
+    //true if ASCII case conversion is only A-Z <-> a-z, which can then be vectorized
+    bool ascii_standard_case;
+
     bool c_is_punctuation(u_uchar str);
     bool c_is_punctuation(wchar_t str);
     bool u_is_punctuation(u_ustring& str);
@@ -257,6 +270,50 @@ public:
     uint32_t min_emoji;
     uint32_t min_emojicomp;
     
+    void ascii_tables() {
+        u_uchar c;
+        ascii_standard_case = true;
+        for (c = 0; c < 128; c++) {
+            ascii_properties[c] = utf8codemin.check(c) + 2 * (char)utf8codemaj.check(c);
+            if (punctuations.check(c))
+                ascii_properties[c] |= 4;
+        
+            ascii_plain[c] = c;
+            if (wvowels.check(c)) {
+                ascii_properties[c] |= 8;
+                ascii_plain[c] = wvowels.at(c);
+            }
+            else {
+                if (wconsonants.check(c))
+                    ascii_plain[c] = wconsonants.at(c);
+            }
+            if (wconsonants.check(c))
+                ascii_properties[c] |= 16;
+        
+            ascii_lower[c] = c;
+            if (utf8codemaj.check(c))
+                ascii_lower[c] = utf8codemaj.at(c);
+            ascii_upper[c] = c;
+            if (utf8codemin.check(c))
+                ascii_upper[c] = utf8codemin.at(c);
+        
+            if (c >= 'A' && c <= 'Z') {
+                if (ascii_lower[c] != c + 32 || ascii_upper[c] != c)
+                    ascii_standard_case = false;
+            }
+            else {
+                if (c >= 'a' && c <= 'z') {
+                    if (ascii_upper[c] != c - 32 || ascii_lower[c] != c)
+                        ascii_standard_case = false;
+                }
+                else {
+                    if (ascii_lower[c] != c || ascii_upper[c] != c)
+                        ascii_standard_case = false;
+                }
+            }
+        }
+    }
+    
     bool c_is_upper(u_uchar c) {
         char ty = c_is_alpha(c);
         if (ty == 2)
@@ -273,10 +330,14 @@ public:
     
     
     bool c_is_consonant(u_uchar c) {
+        if (c < 128)
+            return (ascii_properties[c] & 16);
         return wconsonants.check(c);
     }
     
     bool c_is_vowel(u_uchar c) {
+        if (c < 128)
+            return (ascii_properties[c] & 8);
         return wvowels.check(c);
     }
     
@@ -312,9 +373,14 @@ public:
         long lg = s.size();
         u_uchar code;
         u_ustring v;
+        v.reserve(lg);
         
         for (long i = 0; i < lg; i++) {
             code = s[i];
+            if (code < 128) {
+                v += ascii_plain[code];
+                continue;
+            }
             if (wvowels.check(code))
                 v += wvowels.at(code);
             else {
@@ -78,6 +78,24 @@ public:
             delete vecteur[--last];
         }
     }
+
+    //Deletes the elements beyond nb and shrinks the buffer accordingly
+    //Returns the number of deleted elements
+    inline long trim(long nb) {
+        long removed = 0;
+        while (last > nb) {
+            delete vecteur[--last];
+            vecteur[last] = NULL;
+            removed++;
+        }
+        
+        if (sz > (last << 1) + 16) {
+            sz = last + 16;
+            vecteur = (Z*)realloc(vecteur, sizeof(Z)*sz);
+            memset(vecteur+last, 0, sizeof(Z)*(sz-last));
+        }
+        return removed;
+    }
     
     inline void clean() {
         for (last = 0; last < sz; last++) {
@@ -460,10 +478,21 @@ public:
     }
 
     inline void extend(item_a* val, long val_home) {
-        resize(last+val->last);
-        for (long i = val_home; i < val->last; i++) {
-            buffer[last++] = val->buffer[i];
-        }
+        long nb = val->last - val_home;
+        if (nb <= 0)
+            return;
+        resize(last + nb);
+        //Z is always a plain type (double, float, long, short)
+        memcpy(buffer + last, val->buffer + val_home, sizeof(Z)*nb);
+        last += nb;
+    }
+
+    //Raw copy of nb elements from a plain buffer, starting at pos
+    inline void copy(long pos, Z* b, long nb) {
+        reserve(pos + nb);
+        if (nb > 0)
+            memcpy(buffer + pos, b, sizeof(Z)*nb);
+        last = pos + nb;
     }
 
     inline void push_back(Z val) {
@@ -526,12 +555,129 @@ public:
             buffer[i] /= v;
     }
 
+    //Bitwise operations: they are only instantiated for integer types
+    inline void bit_and(long home, long home_n, Z* n, long nb) {
+        Z* b = buffer + home;
+        n += home_n;
+        for (long i = 0; i < nb; i++)
+            b[i] &= n[i];
+    }
+
+    inline void bit_and(long home, Z v) {
+        Z* b = buffer + home;
+        Z* e = buffer + last;
+        for (; b < e; b++)
+            *b &= v;
+    }
+
+    inline void bit_and_not(long home, long home_n, Z* n, long nb) {
+        Z* b = buffer + home;
+        n += home_n;
+        for (long i = 0; i < nb; i++)
+            b[i] &= ~n[i];
+    }
+
+    inline void bit_and_not(long home, Z v) {
+        Z* b = buffer + home;
+        Z* e = buffer + last;
+        v = ~v;
+        for (; b < e; b++)
+            *b &= v;
+    }
+
+    inline void bit_or(long home, long home_n, Z* n, long nb) {
+        Z* b = buffer + home;
+        n += home_n;
+        for (long i = 0; i < nb; i++)
+            b[i] |= n[i];
+    }
+
+    inline void bit_or(long home, Z v) {
+        Z* b = buffer + home;
+        Z* e = buffer + last;
+        for (; b < e; b++)
+            *b |= v;
+    }
+
+    inline void bit_xor(long home, long home_n, Z* n, long nb) {
+        Z* b = buffer + home;
+        n += home_n;
+        for (long i = 0; i < nb; i++)
+            b[i] ^= n[i];
+    }
+
+    inline void bit_xor(long home, Z v) {
+        Z* b = buffer + home;
+        Z* e = buffer + last;
+        for (; b < e; b++)
+            *b ^= v;
+    }
+
+    inline void leftshift(long home, long home_n, Z* n, long nb) {
+        Z* b = buffer + home;
+        n += home_n;
+        for (long i = 0; i < nb; i++)
+            b[i] <<= n[i];
+    }
+
+    inline void leftshift(long home, Z v) {
+        Z* b = buffer + home;
+        Z* e = buffer + last;
+        for (; b < e; b++)
+            *b <<= v;
+    }
+
+    inline void rightshift(long home, long home_n, Z* n, long nb) {
+        Z* b = buffer + home;
+        n += home_n;
+        for (long i = 0; i < nb; i++)
+            b[i] >>= n[i];
+    }
+
+    inline void rightshift(long home, Z v) {
+        Z* b = buffer + home;
+        Z* e = buffer + last;
+        for (; b < e; b++)
+            *b >>= v;
+    }
+
+    //Pairwise summation: the error grows in O(log n) instead of O(n) for floating values
+    //The four partial sums in the blocks are independent of each other
+    static Z pairwise_sum(Z* v, long nb) {
+        if (nb <= 128) {
+            Z s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            Z* e = v + (nb & ~3);
+            for (; v < e; v += 4) {
+                s0 += v[0];
+                s1 += v[1];
+                s2 += v[2];
+                s3 += v[3];
+            }
+            for (nb &= 3; nb > 0; nb--)
+                s0 += *v++;
+            return (s0 + s1) + (s2 + s3);
+        }
+        long half = (nb >> 1) & ~3;
+        return pairwise_sum(v, half) + pairwise_sum(v + half, nb - half);
+    }
+
     inline Z sum(long home) {
-        Z& s = buffer[sz];
-        s = 0;
-        for (long i = home; i < last; i++)
-            s += buffer[i];
-        return s;
+        return pairwise_sum(buffer + home, last - home);
+    }
+
+    //Compensated summation (Kahan-Babuska/Neumaier), for floating values
+    inline Z compensated_sum(long home) {
+        Z s = 0, c = 0, t, v;
+        for (long i = home; i < last; i++) {
+            v = buffer[i];
+            t = s + v;
+            if ((s < 0?-s:s) >= (v < 0?-v:v))
+                c += (s - t) + v;
+            else
+                c += (v - t) + s;
+            s = t;
+        }
+        return s + c;
     }
 
     inline Z product(long home) {
@@ -552,35 +698,68 @@ public:
         v = (v>m)?v:m;
     }
 
+    //The extrema are computed over four independent lanes
     inline Z mini(long home) {
         if (last == home)
             return 0;
-        Z& m = buffer[sz];
-        m = buffer[home];
-        for (long i = home + 1; i < last; i++)
-            minvalue(m, buffer[i]);
-        return m;
+        Z m0 = buffer[home], m1 = m0, m2 = m0, m3 = m0;
+        Z* v = buffer + home + 1;
+        Z* e = v + ((last - home - 1) & ~3);
+        for (; v < e; v += 4) {
+            minvalue(m0, v[0]);
+            minvalue(m1, v[1]);
+            minvalue(m2, v[2]);
+            minvalue(m3, v[3]);
+        }
+        for (e = buffer + last; v < e; v++)
+            minvalue(m0, *v);
+        minvalue(m0, m1);
+        minvalue(m2, m3);
+        minvalue(m0, m2);
+        return m0;
     }
 
     inline Z maxi(long home) {
         if (last == home)
             return 0;
-        Z& M = buffer[sz];
-        M = buffer[home];
-        for (long i = home + 1; i < last; i++)
-            maxvalue(M, buffer[i]);
-        return M;
+        Z M0 = buffer[home], M1 = M0, M2 = M0, M3 = M0;
+        Z* v = buffer + home + 1;
+        Z* e = v + ((last - home - 1) & ~3);
+        for (; v < e; v += 4) {
+            maxvalue(M0, v[0]);
+            maxvalue(M1, v[1]);
+            maxvalue(M2, v[2]);
+            maxvalue(M3, v[3]);
+        }
+        for (e = buffer + last; v < e; v++)
+            maxvalue(M0, *v);
+        maxvalue(M0, M1);
+        maxvalue(M2, M3);
+        maxvalue(M0, M2);
+        return M0;
     }
 
     inline bool minmax(long home, Z& m, Z& M) {
         if (last == home)
             return false;
-        m = buffer[home];
-        M = m;
-        for (long i = home + 1; i < last; i++) {
-            minvalue(m, buffer[i]);
-            maxvalue(M, buffer[i]);
+        Z m0 = buffer[home], m1 = m0;
+        Z M0 = m0, M1 = m0;
+        Z* v = buffer + home + 1;
+        Z* e = v + ((last - home - 1) & ~1);
+        for (; v < e; v += 2) {
+            minvalue(m0, v[0]);
+            maxvalue(M0, v[0]);
+            minvalue(m1, v[1]);
+            maxvalue(M1, v[1]);
         }
+        if (v < buffer + last) {
+            minvalue(m0, *v);
+            maxvalue(M0, *v);
+        }
+        minvalue(m0, m1);
+        maxvalue(M0, M1);
+        m = m0;
+        M = M0;
         return true;
     }
 
@@ -609,10 +788,7 @@ public:
     vecte_a(vecte_a<Z>& l) {
         home = 0;
         items = new item_a<Z>(l.size());
-        while (items->last < l.items->last - l.home) {
-            items->buffer[items->last] = l[items->last];
-            items->last++;
-        }
+        items->copy(0, l.items->buffer + l.home, l.size());
     }
 
     vecte_a(vecte_a<Z>& l, long pos) {
@@ -648,6 +824,7 @@ public:
     }
     
     inline void put(long pos, Z val) {
+        detach();
         items->buffer[pos + home] = val;
     }
 
@@ -655,13 +832,59 @@ public:
         return status + (items->status != 0);
     }
 
+    //Copy-on-write: a buffer can be shared with other vectors (see share).
+    //Every method that modifies the values first calls detach, which gives
+    //this vector its own copy of [home, last[ if the buffer is shared.
+    //Direct writes through operator[] must be preceded with a call to detach
+    //(see copyatom in the typed containers)
+    inline void detach() {
+        if (items->status)
+            unshare();
+    }
+
+    void unshare() {
+        long nb = size();
+        item_a<Z>* values = new item_a<Z>(nb < 8?8:nb);
+        values->copy(0, items->buffer + home, nb);
+        items->status--;
+        items = values;
+        home = 0;
+    }
+
+    //We drop our own buffer to point to the buffer of l from pos
+    //This is the same mechanism as the vecte_a(l, pos) constructor
+    void share(vecte_a<Z>& l, long pos) {
+        if (l.items == items) {
+            //The offset is relative to l, which can be a view itself
+            home = l.home + pos;
+            return;
+        }
+        
+        if (!items->status)
+            delete items;
+        else
+            items->status--;
+        home = pos + l.home;
+        items = l.items;
+        items->status++;
+    }
+
+    //We copy the values of l from pos in one single block
+    //clear() gives us our own buffer if it was shared, hence no overlap with l
+    void copy_from(vecte_a<Z>& l, long pos) {
+        clear();
+        items->copy(0, l.items->buffer + l.home + pos, l.size() - pos);
+    }
+
     inline Z exchange(long pos, Z val) {
+        detach();
         Z e = items->buffer[pos + home];
         items->buffer[pos + home] = val;
         return e;
     }
 
     inline Z exchangelast(Z val) {
+        detach();
         Z e = items->buffer[items->last - 1];
         items->buffer[items->last - 1] = val;
         return e;
@@ -685,22 +908,29 @@ public:
     }
 
     void clean() {
-        items->last = home;
+        if (items->status)
+            clear();
+        else
+            items->last = home;
     }
     
     inline void pop_back() {
+        detach();
         items->last--;
     }
 
     inline void swap(long i, long j) {
-        items->swap(i, j);
+        detach();
+        items->swap(i + home, j + home);
     }
     
     inline void beforelast(Z val) {
+        detach();
         items->beforelast(val);
     }
 
     inline void insert(long pos, Z val) {
+        detach();
         items->insert(pos + home, val);
     }
 
@@ -709,11 +939,13 @@ public:
     }
 
     inline void push_back(Z val) {
+        detach();
         items->push_back(val);
     }
 
     inline void extend(vecte_a<Z>* val) {
-        items->extend(val->item, val->home);
+        detach();
+        items->extend(val->items, val->home);
     }
 
     inline Z& operator[](long pos) {
@@ -721,10 +953,12 @@ public:
     }
     
     void erase(long pos) {
+        detach();
         items->erase(pos +home);
     }
 
     void reverse() {
+        detach();
         long sz = items->last - 1;
         for (long i = home; i < sz && items->reverse(i,sz); i++) {
             sz--;
@@ -732,13 +966,44 @@ public:
     }
         
     void operator =(vecte_a<Z>& z) {
-        items->last = home;
-        items->reserve(z.items->sz);
-        for (long i = z.home; i < z.items->last; i++)
-            items->buffer[items->last++] = z.items->buffer[i];
+        long nb = z.size();
+        //Our current values are replaced, there is no need to copy them
+        if (items->status && z.items != items)
+            clear();
+        
+        if (z.items == items) {
+            if (&z == this)
+                return;
+            //Both vectors share the same buffer: detach gives us a new one,
+            //while z keeps the original buffer, which we copy from
+            item_a<Z>* source = z.items;
+            long from = z.home;
+            detach();
+            items->copy(home, source->buffer + from, nb);
+            return;
+        }
+        items->copy(home, z.items->buffer + z.home, nb);
+    }
+
+    //The vector now contains nb values, which are not initialized
+    //It returns the buffer, which must be filled by the caller
+    inline Z* allocate(long nb) {
+        clear();
+        items->reserve(nb);
+        items->last = nb;
+        return items->buffer;
+    }
+
+    //Replaces the content with nb values from a plain buffer
+    inline void assign(Z* b, long nb) {
+        if (items->status)
+            clear();
+        items->copy(home, b, nb);
     }
 
     void operator =(vecte<Z>& z) {
+        if (items->status)
+            clear();
         items->last = home;
         items->reserve(z.size());
         for (long i = 0; i < z.size(); i++)
@@ -750,18 +1015,22 @@ public:
     }
 
     inline void at(long pos, Z val) {
+        detach();
         items->at(pos + home, val);
     }
 
     inline void atlast(Z val) {
+        detach();
         items->atlast(val);
     }
 
     inline void padding(long nb) {
+        detach();
         items->padding(nb + home);
     }
 
     inline void padding(long nb, Z v) {
+        detach();
         items->padding(nb + home, v);
     }
     
@@ -800,12 +1069,20 @@ public:
     }
     
     bool compare(LispE* lisp, List* comparison, short instruction, long i, long j);
-    void values_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax);
+    void values_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax, long depth);
+    void values_sifting(LispE* lisp, List* comparison, short instruction, long base, long root, long nb);
+    void values_heap_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax);
+    void values_stable_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax, Z* buffer);
+    void values_sorting(LispE* lisp, List* comparison, bool stable);
     
     Z sum() {
         return items->sum(home);
     }
 
+    Z compensated_sum() {
+        return items->compensated_sum(home);
+    }
+
     Z product() {
         return items->product(home);
     }
@@ -827,37 +1104,105 @@ public:
     }
 
     long replaceall(Z test, Z value) {
+        detach();
         return items->replaceall(home, test, value);
     }
     
     void plus(vecte_a<Z>& n, long nb) {
+        detach();
         items->plus(home, n.home, n.items->buffer, nb);
     }
 
     void minus(vecte_a<Z>& n, long nb) {
+        detach();
         items->minus(home, n.home, n.items->buffer, nb);
     }
 
     void multiply(vecte_a<Z>& n, long nb) {
+        detach();
         items->multiply(home, n.home, n.items->buffer, nb);
     }
 
     void plus(Z v) {
+        detach();
         items->plus(home, v);
     }
 
     void minus(Z v) {
+        detach();
         items->minus(home, v);
     }
 
     void multiply(Z v) {
+        detach();
         items->multiply(home, v);
     }
 
     void divide(Z v) {
+        detach();
         items->divide(home, v);
     }
 
+    void bit_and(vecte_a<Z>& n, long nb) {
+        detach();
+        items->bit_and(home, n.home, n.items->buffer, nb);
+    }
+
+    void bit_and(Z v) {
+        detach();
+        items->bit_and(home, v);
+    }
+
+    void bit_and_not(vecte_a<Z>& n, long nb) {
+        detach();
+        items->bit_and_not(home, n.home, n.items->buffer, nb);
+    }
+
+    void bit_and_not(Z v) {
+        detach();
+        items->bit_and_not(home, v);
+    }
+
+    void bit_or(vecte_a<Z>& n, long nb) {
+        detach();
+        items->bit_or(home, n.home, n.items->buffer, nb);
+    }
+
+    void bit_or(Z v) {
+        detach();
+        items->bit_or(home, v);
+    }
+
+    void bit_xor(vecte_a<Z>& n, long nb) {
+        detach();
+        items->bit_xor(home, n.home, n.items->buffer, nb);
+    }
+
+    void bit_xor(Z v) {
+        detach();
+        items->bit_xor(home, v);
+    }
+
+    void leftshift(vecte_a<Z>& n, long nb) {
+        detach();
+        items->leftshift(home, n.home, n.items->buffer, nb);
+    }
+
+    void leftshift(Z v) {
+        detach();
+        items->leftshift(home, v);
+    }
+
+    void rightshift(vecte_a<Z>& n, long nb) {
+        detach();
+        items->rightshift(home, n.home, n.items->buffer, nb);
+    }
+
+    void rightshift(Z v) {
+        detach();
+        items->rightshift(home, v);
+    }
+
     void searchall(vecte_a<long>& indexes, Z v, long ix) {
         for (long i = home + ix; i < items->last; i++) {
             if (items->buffer[i] == v)
@@ -867,6 +1212,118 @@ public:
     
 };
 
+//--------------------------------------------------------------------------------
+//A dense matrix stored in one single contiguous buffer, with strides.
+//This is the working storage of the numerical kernels on Matrice and Matrice_float,
+//which are otherwise lists of separately allocated rows.
+//A view shares the buffer of its parent through the item_a reference counter:
+//transposing or restricting a view only modifies its sizes, strides and offset.
+template <class Z> class dense_matrix {
+public:
+    item_a<Z>* items;
+    long size_x, size_y;
+    long stride_x, stride_y;
+    long offset;
+
+    dense_matrix(long x, long y) {
+        size_x = x;
+        size_y = y;
+        stride_x = y;
+        stride_y = 1;
+        offset = 0;
+        items = new item_a<Z>(x*y);
+        items->last = x*y;
+        memset(items->buffer, 0, sizeof(Z)*items->last);
+    }
+
+    //A copy would share the buffer without its reference counter
+    dense_matrix(const dense_matrix<Z>& m) = delete;
+    dense_matrix<Z>& operator=(const dense_matrix<Z>& m) = delete;
+
+    ~dense_matrix() {
+        if (!items->status)
+            delete items;
+        else
+            items->status--;
+    }
+
+    inline Z& operator()(long i, long j) {
+        return items->buffer[offset + i*stride_x + j*stride_y];
+    }
+
+    //When stride_y is 1, a row is contiguous in memory
+    inline Z* row(long i) {
+        return items->buffer + offset + i*stride_x;
+    }
+
+    inline bool contiguous() {
+        return (stride_y == 1 && stride_x == size_y);
+    }
+
+    inline void transpose() {
+        long v = size_x;
+        size_x = size_y;
+        size_y = v;
+        v = stride_x;
+        stride_x = stride_y;
+        stride_y = v;
+    }
+
+    //The view is restricted to the sub-matrix: [x, x+nx[ x [y, y+ny[
+    inline void restrict(long x, long y, long nx, long ny) {
+        offset += x*stride_x + y*stride_y;
+        size_x = nx;
+        size_y = ny;
+    }
+
+    //We copy the values of this view into the rows of res (one pointer per row)
+    //The copy is done through blocks, to remain cache friendly when the view is transposed
+    void copy_into(Z** res) {
+        long i, j;
+        if (stride_y == 1) {
+            for (i = 0; i < size_x; i++)
+                memcpy(res[i], row(i), sizeof(Z)*size_y);
+            return;
+        }
+
+        const long block = 32;
+        long ib, jb, imax, jmax;
+        for (ib = 0; ib < size_x; ib += block) {
+            imax = (ib + block < size_x)?ib + block:size_x;
+            for (jb = 0; jb < size_y; jb += block) {
+                jmax = (jb + block < size_y)?jb + block:size_y;
+                for (i = ib; i < imax; i++) {
+                    for (j = jb; j < jmax; j++)
+                        res[i][j] = operator()(i, j);
+                }
+            }
+        }
+    }
+
+    //The view gets its own contiguous buffer
+    void compact() {
+        if (contiguous() && !offset && !items->status)
+            return;
+        
+        item_a<Z>* values = new item_a<Z>(size_x*size_y);
+        values->last = size_x*size_y;
+        Z** rows = new Z*[size_x];
+        for (long i = 0; i < size_x; i++)
+            rows[i] = values->buffer + i*size_y;
+        copy_into(rows);
+        delete[] rows;
+        
+        if (!items->status)
+            delete items;
+        else
+            items->status--;
+        items = values;
+        stride_x = size_y;
+        stride_y = 1;
+        offset = 0;
+    }
+};
+
 //We use the new method here. The alloc cannot work for strings...
 template <class Z> class item_n {
 public:
@@ -1107,6 +1564,7 @@ public:
     }
 
     inline void put(long pos, Z val) {
+        detach();
         items->buffer[pos + home] = val;
     }
 
@@ -1114,13 +1572,49 @@ public:
         return status + (items->status != 0);
     }
 
+    //Copy-on-write, as in vecte_a: the methods that modify the values call detach first.
+    //swap works on absolute positions for values_sorting, the caller detaches beforehand.
+    inline void detach() {
+        if (items->status)
+            unshare();
+    }
+
+    void unshare() {
+        long nb = size();
+        item_n<Z>* values = new item_n<Z>(nb < 8?8:nb);
+        for (long i = 0; i < nb; i++)
+            values->buffer[i] = items->buffer[i + home];
+        values->last = nb;
+        items->status--;
+        items = values;
+        home = 0;
+    }
+
+    //We drop our own buffer to point to the buffer of l from pos
+    void share(vecte_n<Z>& l, long pos) {
+        if (l.items == items) {
+            home = l.home + pos;
+            return;
+        }
+        
+        if (!items->status)
+            delete items;
+        else
+            items->status--;
+        home = pos + l.home;
+        items = l.items;
+        items->status++;
+    }
+
     inline Z exchange(long pos, Z val) {
+        detach();
         Z e = items->buffer[pos + home];
         items->buffer[pos + home] = val;
         return e;
     }
 
     inline Z exchangelast(Z val) {
+        detach();
         Z e = items->buffer[items->last - 1];
         items->buffer[items->last - 1] = val;
         return e;
@@ -1144,10 +1638,14 @@ public:
     }
 
     void clean() {
-        items->last = home;
+        if (items->status)
+            clear();
+        else
+            items->last = home;
     }
     
     inline void pop_back() {
+        detach();
         items->last--;
     }
 
@@ -1156,10 +1654,12 @@ public:
     }
     
     inline void beforelast(Z val) {
+        detach();
         items->beforelast(val);
     }
 
     inline void insert(long pos, Z val) {
+        detach();
         items->insert(pos + home, val);
     }
 
@@ -1168,11 +1668,13 @@ public:
     }
 
     inline void push_back(Z val) {
+        detach();
         items->push_back(val);
     }
 
     inline void extend(vecte_n<Z>* val) {
-        items->extend(val->item, val->home);
+        detach();
+        items->extend(val->items, val->home);
     }
 
     inline Z& operator[](long pos) {
@@ -1180,6 +1682,7 @@ public:
     }
     
     void erase(long pos) {
+        detach();
         items->erase(pos +home);
     }
 
@@ -1188,6 +1691,7 @@ public:
     }
     
     void reverse() {
+        detach();
         long sz = items->last - 1;
         for (long i = home; i < sz && items->reverse(i,sz); i++) {
             sz--;
@@ -1195,10 +1699,19 @@ public:
     }
         
     void operator =(vecte_n<Z>& z) {
+        if (&z == this)
+            return;
+        //Our current values are replaced, there is no need to copy them.
+        //If z shares our buffer, it keeps it alive while we read from it
+        item_n<Z>* source = z.items;
+        long from = z.home;
+        long nb = z.size();
+        if (items->status)
+            clear();
         items->last = home;
-        items->reserve(z.items->sz);
-        for (long i = z.home; i < z.items->last; i++)
-            items->buffer[items->last++] = z.items->buffer[i];
+        items->reserve(home + nb);
+        for (long i = 0; i < nb; i++)
+            items->buffer[items->last++] = source->buffer[from + i];
     }
     
     inline bool empty() {
@@ -1206,10 +1719,12 @@ public:
     }
 
     inline void at(long pos, Z val) {
+        detach();
         items->at(pos + home, val);
     }
 
     inline void atlast(Z val) {
+        detach();
         items->atlast(val);
     }
 
@@ -1248,7 +1763,11 @@ public:
     }
 
     bool compare(LispE* lisp, List* comparison, short instruction, long i, long j);
-    void values_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax);
+    void values_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax, long depth);
+    void values_sifting(LispE* lisp, List* comparison, short instruction, long base, long root, long nb);
+    void values_heap_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax);
+    void values_stable_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax, Z* buffer);
+    void values_sorting(LispE* lisp, List* comparison, bool stable);
 
     Z sum() {
         return items->sum(home);
@@ -1271,10 +1790,12 @@ public:
     }
 
     void plus(Z& v) {
+        detach();
         items->plus(home, v);
     }
 
     long replaceall(Z& test, Z& value) {
+        detach();
         return items->replaceall(home, test, value);
     }
 
@@ -90,6 +90,8 @@ void Dictionarypool::decrement() {
         dictionary.clear();
         lisp->dictionary_pool.push_back(this);
     }
+    else
+        lisp->cycle_candidate(this);
     marking = false;
 }
 
@@ -106,7 +108,24 @@ void Dictionarypool::decrementstatus(uint16_t nb) {
         dictionary.clear();
         lisp->dictionary_pool.push_back(this);
     }
+    else
+        lisp->cycle_candidate(this);
+    marking = false;
+}
+
+//This dictionary is only referenced through cycles (see LispE::collect_cycles)
+long Dictionarypool::collect(std::unordered_map<Element*, long>& nodes) {
+    long bytes = sizeof(Dictionarypool) + dictionary.size() * (sizeof(u_ustring) + sizeof(Element*));
+    for (auto& a : dictionary) {
+        auto it = nodes.find(a.second);
+        if (it == nodes.end() || it->second)
+            a.second->decrement();
+    }
+    status = 0;
     marking = false;
+    dictionary.clear();
+    lisp->dictionary_pool.push_back(this);
+    return bytes;
 }
 
 void Dictionarypool::release() {
@@ -228,6 +247,8 @@ void Dictionary_npool::decrement() {
         dictionary.clear();
         lisp->dictionaryn_pool.push_back(this);
     }
+    else
+        lisp->cycle_candidate(this);
     marking = false;
 }
 
@@ -243,7 +264,24 @@ void Dictionary_npool::decrementstatus(uint16_t nb) {
         dictionary.clear();
         lisp->dictionaryn_pool.push_back(this);
     }
+    else
+        lisp->cycle_candidate(this);
+    marking = false;
+}
+
+//This dictionary is only referenced through cycles (see LispE::collect_cycles)
+long Dictionary_npool::collect(std::unordered_map<Element*, long>& nodes) {
+    long bytes = sizeof(Dictionary_npool) + dictionary.size() * (sizeof(double) + sizeof(Element*));
+    for (auto& a : dictionary) {
+        auto it = nodes.find(a.second);
+        if (it == nodes.end() || it->second)
+            a.second->decrement();
+    }
+    status = 0;
     marking = false;
+    dictionary.clear();
+    lisp->dictionaryn_pool.push_back(this);
+    return bytes;
 }
 
 void Dictionary_npool::release() {
@@ -331,6 +369,8 @@ void Dictionary_ipool::decrement() {
         dictionary.clear();
         lisp->dictionaryi_pool.push_back(this);
     }
+    else
+        lisp->cycle_candidate(this);
     marking = false;
 }
 
@@ -346,7 +386,24 @@ void Dictionary_ipool::decrementstatus(uint16_t nb) {
         dictionary.clear();
         lisp->dictionaryi_pool.push_back(this);
     }
+    else
+        lisp->cycle_candidate(this);
+    marking = false;
+}
+
+//This dictionary is only referenced through cycles (see LispE::collect_cycles)
+long Dictionary_ipool::collect(std::unordered_map<Element*, long>& nodes) {
+    long bytes = sizeof(Dictionary_ipool) + dictionary.size() * (sizeof(long) + sizeof(Element*));
+    for (auto& a : dictionary) {
+        auto it = nodes.find(a.second);
+        if (it == nodes.end() || it->second)
+            a.second->decrement();
+    }
+    status = 0;
     marking = false;
+    dictionary.clear();
+    lisp->dictionaryi_pool.push_back(this);
+    return bytes;
 }
 
 void Dictionary_ipool::release() {
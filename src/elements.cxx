@@ -173,8 +173,11 @@ Element* List::copyatom(LispE* lisp, uint16_t s) {
 }
 
 Element* Floats::copyatom(LispE* lisp, uint16_t s) {
-    if (liste.shared(status) < s)
+    if (liste.shared(status) < s) {
+        //The values are going to be modified in place
+        liste.detach();
         return this;
+    }
     
     Floats* f = lisp->provideFloats(this);
     release();
@@ -182,8 +185,11 @@ Element* Floats::copyatom(LispE* lisp, uint16_t s) {
 }
 
 Element* Numbers::copyatom(LispE* lisp, uint16_t s) {
-    if (liste.shared(status) < s)
+    if (liste.shared(status) < s) {
+        //The values are going to be modified in place
+        liste.detach();
         return this;
+    }
 
     Numbers* n = lisp->provideNumbers(this);
     release();
@@ -191,8 +197,11 @@ Element* Numbers::copyatom(LispE* lisp, uint16_t s) {
 }
 
 Element* Integers::copyatom(LispE* lisp, uint16_t s) {
-    if (liste.shared(status) < s)
+    if (liste.shared(status) < s) {
+        //The values are going to be modified in place
+        liste.detach();
         return this;
+    }
 
     Integers* i = lisp->provideIntegers(this);
     release();
@@ -200,8 +209,11 @@ Element* Integers::copyatom(LispE* lisp, uint16_t s) {
 }
 
 Element* Strings::copyatom(LispE* lisp, uint16_t s) {
-    if (liste.shared(status) < s)
+    if (liste.shared(status) < s) {
+        //The values are going to be modified in place
+        liste.detach();
         return this;
+    }
 
     Strings* sl = lisp->provideStrings(this);
     release();
@@ -1157,13 +1169,13 @@ Element* s_findall(LispE* lisp, u_ustring& s, u_ustring& sub, long from) {
     if (!sz)
         return emptylist_;
     
-    long pos = s.find(sub, from);
+    long pos = u_find(s, sub, from);
     if (pos == -1)
         return emptylist_;
     Integers* liste = lisp->provideIntegers();
     while (pos != -1) {
         liste->liste.push_back(pos);
-        pos=s.find(sub,pos+sz);
+        pos = u_find(s, sub, pos+sz);
     }
     return liste;
 }
@@ -1173,13 +1185,13 @@ Element* s_count(LispE* lisp, u_ustring& s, u_ustring& sub, long from) {
     if (!sz)
         return zero_;
     
-    long pos = s.find(sub, from);
+    long pos = u_find(s, sub, from);
     if (pos == -1)
         return zero_;
     long nb = 0;
     while (pos != -1) {
         nb++;
-        pos=s.find(sub,pos+sz);
+        pos = u_find(s, sub, pos+sz);
     }
     return lisp->provideInteger(nb);
 }
@@ -1286,7 +1298,7 @@ Element* Element::search_element(LispE* lisp, Element* valeur, long ix) {
 
 Element* String::search_element(LispE* lisp, Element* valeur, long ix) {
     u_ustring val = valeur->asUString(lisp);
-    ix =  content.find(val, ix);
+    ix =  u_find(content, val, ix);
     return (ix == -1)?null_:lisp->provideInteger(ix);
 }
 
@@ -1297,7 +1309,7 @@ bool Element::check_element(LispE* lisp, Element* valeur) {
 
 bool String::check_element(LispE* lisp, Element* valeur) {
     u_ustring val = valeur->asUString(lisp);
-    return (content.find(val, 0) != -1);
+    return (u_find(content, val, 0) != -1);
 }
 
 //------------------------------------------------------------------------------------------
@@ -1325,7 +1337,6 @@ Element* Element::search_all_elements(LispE* lisp, Element* valeur, long ix) {
 
 Element* String::search_all_elements(LispE* lisp, Element* valeur, long ix) {
     u_ustring val = valeur->asUString(lisp);
-    ix =  content.find(val, ix);
     return s_findall(lisp,content, val, ix);
 }
 
@@ -1336,7 +1347,6 @@ Element* Element::count_all_elements(LispE* lisp, Element* valeur, long ix) {
 
 Element* String::count_all_elements(LispE* lisp, Element* valeur, long ix) {
     u_ustring val = valeur->asUString(lisp);
-    ix =  content.find(val, ix);
     return s_count(lisp,content, val, ix);
 }
 
@@ -1408,7 +1418,7 @@ Element* Element::search_reverse(LispE* lisp, Element* valeur, long ix) {
 
 Element* String::search_reverse(LispE* lisp, Element* valeur, long ix) {
     u_ustring val = valeur->asUString(lisp);
-    ix =  content.rfind(val, content.size() - ix);
+    ix =  u_rfind(content, val, content.size() - ix);
     return (ix == -1)?null_:lisp->provideInteger(ix);
 }
 
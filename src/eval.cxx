@@ -3446,6 +3446,20 @@ Element* List::evall_innerproduct(LispE* lisp) {
         if (sy_1 != sx_2)
             throw new Error("Error: incompatible matrices");
 
+        //A genuine matrix multiplication on numerical matrices
+        if (op1->type == l_plus && op2->type == l_multiply &&
+            (l1->type == t_matrix || l1->type == t_matrix_float) &&
+            (l2->type == t_matrix || l2->type == t_matrix_float) &&
+            dense_rows(l1) && dense_rows(l2)) {
+            e = matrix_product(lisp, l1, l2);
+            l1->release();
+            l2->release();
+            op1->release();
+            op2->release();
+            lisp->set_true_as_true();
+            return e;
+        }
+
         Element* l2_transposed;
         long i, j = 0;
         
@@ -3482,6 +3496,218 @@ Element* List::evall_innerproduct(LispE* lisp) {
     return null_;
 }
 
+//------------------------------------------------------------------------------------------
+//Native versions of scan, backscan and outer product
+//When the operator is a basic arithmetic or comparison operator (or max/min) and the lists
+//are numerical containers, we loop directly on the buffers instead of building a call for each value
+static bool native_operator(short op, bool comparison) {
+    switch (op) {
+        case l_plus:
+        case l_minus:
+        case l_multiply:
+        case l_divide:
+        case l_max:
+        case l_min:
+            return true;
+        case l_equalonezero:
+        case l_different:
+        case l_lower:
+        case l_greater:
+        case l_lowerorequal:
+        case l_greaterorequal:
+            return comparison;
+    }
+    return false;
+}
+
+template <class Z> static inline Z native_value(short op, Z a, Z b) {
+    switch (op) {
+        case l_plus:
+            return a + b;
+        case l_minus:
+            return a - b;
+        case l_multiply:
+            return a * b;
+        case l_divide:
+            if (b == 0)
+                throw new Error("Error: division by zero");
+            return a / b;
+        case l_max:
+            return (a < b)?b:a;
+        case l_min:
+            return (b < a)?b:a;
+        case l_equalonezero:
+            return (a == b);
+        case l_different:
+            return (a != b);
+        case l_lower:
+            return (a < b);
+        case l_greater:
+            return (a > b);
+        case l_lowerorequal:
+            return (a <= b);
+        case l_greaterorequal:
+            return (a >= b);
+    }
+    return a;
+}
+
+static inline Element* native_element(LispE* lisp, double v) {
+    return lisp->provideNumber(v);
+}
+
+static inline Element* native_element(LispE* lisp, float v) {
+    return lisp->provideFloat(v);
+}
+
+static inline Element* native_element(LispE* lisp, long v) {
+    return lisp->provideInteger(v);
+}
+
+//The values of a numerical container converted into Z
+template <class Z> static Z* native_values(Element* l) {
+    long sz = l->size();
+    Z* values = new Z[sz];
+    long i;
+    switch (l->type) {
+        case t_numbers: {
+            double* b = ((Numbers*)l)->liste.items->buffer + ((Numbers*)l)->liste.home;
+            for (i = 0; i < sz; i++)
+                values[i] = b[i];
+            break;
+        }
+        case t_floats: {
+            float* b = ((Floats*)l)->liste.items->buffer + ((Floats*)l)->liste.home;
+            for (i = 0; i < sz; i++)
+                values[i] = b[i];
+            break;
+        }
+        case t_integers: {
+            long* b = ((Integers*)l)->liste.items->buffer + ((Integers*)l)->liste.home;
+            for (i = 0; i < sz; i++)
+                values[i] = b[i];
+            break;
+        }
+    }
+    return values;
+}
+
+static bool native_container(short type) {
+    return (type == t_numbers || type == t_floats || type == t_integers);
+}
+
+//scan goes from left to right, backscan from right to left
+//The result is a list of atoms, as with the generic version
+template <class Z> static void native_scanning(LispE* lisp, short op, Z* values, long sz, bool back, List* res) {
+    long i = 0;
+    long inc = 1;
+    if (back) {
+        i = sz - 1;
+        inc = -1;
+    }
+
+    Z acc = values[i];
+    res->append(native_element(lisp, acc));
+    for (long nb = 1; nb < sz; nb++) {
+        i += inc;
+        acc = native_value<Z>(op, acc, values[i]);
+        res->append(native_element(lisp, acc));
+    }
+}
+
+//Comparisons are only handled natively on integers, as the generic version compares
+//the 0/1 they return as integers against the next value...
+//Divisions on integers return either integers or numbers, they are kept on the generic path
+//Returns NULL when the generic path must be used. If the operator fails (division by zero),
+//the result is released here, the caller has only its own arguments to release
+static List* native_scan(LispE* lisp, Element* l1, short op, bool back) {
+    if (!native_operator(op, l1->type == t_integers))
+        return NULL;
+    if (!native_container(l1->type) || (l1->type == t_integers && op == l_divide))
+        return NULL;
+
+    long sz = l1->size();
+    List* res = lisp->provideList();
+    try {
+        switch (l1->type) {
+            case t_numbers:
+                native_scanning<double>(lisp, op, ((Numbers*)l1)->liste.items->buffer + ((Numbers*)l1)->liste.home, sz, back, res);
+                break;
+            case t_floats:
+                native_scanning<float>(lisp, op, ((Floats*)l1)->liste.items->buffer + ((Floats*)l1)->liste.home, sz, back, res);
+                break;
+            default:
+                native_scanning<long>(lisp, op, ((Integers*)l1)->liste.items->buffer + ((Integers*)l1)->liste.home, sz, back, res);
+        }
+    }
+    catch (Error* err) {
+        res->release();
+        throw err;
+    }
+    return res;
+}
+
+static inline double* native_row(Matrice* m, long i) {
+    return ((Numbers*)m->liste[i])->liste.items->buffer + ((Numbers*)m->liste[i])->liste.home;
+}
+
+static inline float* native_row(Matrice_float* m, long i) {
+    return ((Floats*)m->liste[i])->liste.items->buffer + ((Floats*)m->liste[i])->liste.home;
+}
+
+//The outer product of two numerical vectors is written directly into the rows of the matrix
+template <class Z, class M> static void native_outer(short op, Z* a, long nx, Z* b, long ny, M* m) {
+    Z* row;
+    for (long i = 0; i < nx; i++) {
+        row = native_row(m, i);
+        for (long j = 0; j < ny; j++)
+            row[j] = native_value<Z>(op, a[i], b[j]);
+    }
+}
+
+//Mixing integers and numbers in a comparison or in max/min relies on the type of the first
+//argument, hence these operators are only handled natively when both containers share the same type
+static Element* native_outerproduct(LispE* lisp, Element* l1, short op, Element* l2) {
+    if (!native_container(l1->type) || !native_container(l2->type))
+        return NULL;
+
+    if (!native_operator(op, l1->type == l2->type) ||
+        (l1->type != l2->type && (op == l_max || op == l_min)))
+        return NULL;
+
+    long nx = l1->size();
+    long ny = l2->size();
+    if (l1->type == t_floats && l2->type == t_floats) {
+        Matrice_float* m = new Matrice_float(lisp, nx, ny, 0.0);
+        try {
+            native_outer<float>(op, ((Floats*)l1)->liste.items->buffer + ((Floats*)l1)->liste.home, nx,
+                                ((Floats*)l2)->liste.items->buffer + ((Floats*)l2)->liste.home, ny, m);
+        }
+        catch (Error* err) {
+            m->release();
+            throw err;
+        }
+        return m;
+    }
+
+    Matrice* m = new Matrice(lisp, nx, ny, 0.0);
+    double* a = native_values<double>(l1);
+    double* b = native_values<double>(l2);
+    try {
+        native_outer<double>(op, a, nx, b, ny, m);
+    }
+    catch (Error* err) {
+        delete[] a;
+        delete[] b;
+        m->release();
+        throw err;
+    }
+    delete[] a;
+    delete[] b;
+    return m;
+}
+//------------------------------------------------------------------------------------------
+
 // (° '(2 3 4) '* '(1 2 3 4))
 // (° (rho 2 3 '(4 5 6 9)) '* (rho 3 3 (iota 10)))
 Element* List::evall_outerproduct(LispE* lisp) {
@@ -3528,6 +3754,17 @@ Element* List::evall_outerproduct(LispE* lisp) {
         op = liste[2]->eval(lisp);
         if (op->type == l_equal)
             op = lisp->provideAtom(l_equalonezero);
+
+        res = native_outerproduct(lisp, l1, op->type, l2);
+        if (res != NULL) {
+            l1->release();
+            l2->release();
+            op->release();
+            lisp->set_true_as_true();
+            return res;
+        }
+        res = null_;
+
         call = lisp->provideList();
         call->append(op);
         call->append(null_);
@@ -3872,8 +4109,12 @@ Element* List::evall_reduce(LispE* lisp) {
         throw err;
     }
 
+    //max and min on numerical containers are computed in one single call, as for operators
+    bool extremum = ((op->type == l_max || op->type == l_min) &&
+                     (l1->type == t_numbers || l1->type == t_floats || l1->type == t_integers || l1->type == t_shorts));
+
     List* call = lisp->provideList();
-    if (!op->isLambda())
+    if (!op->isLambda() && !extremum)
         op = op->eval(lisp);
     
     short arg1 = 0;
@@ -3955,7 +4196,7 @@ Element* List::evall_reduce(LispE* lisp) {
     call->append(op);
     methodEval met = lisp->delegation->evals[op->type];
 
-    if (op->isOperator()) {
+    if (op->isOperator() || extremum) {
         call->append(lisp->provideQuoted(l1));
         
         try {
@@ -4196,8 +4437,12 @@ Element* List::evall_backreduce(LispE* lisp) {
         throw err;
     }
 
+    //max and min on numerical containers are computed in one single call, as for operators
+    bool extremum = ((op->type == l_max || op->type == l_min) &&
+                     (l1->type == t_numbers || l1->type == t_floats || l1->type == t_integers || l1->type == t_shorts));
+
     List* call = lisp->provideList();
-    if (!op->isLambda())
+    if (!op->isLambda() && !extremum)
         op = op->eval(lisp);
     
     short arg1 = 0;
@@ -4283,7 +4528,7 @@ Element* List::evall_backreduce(LispE* lisp) {
     call->append(op);
     methodEval met = lisp->delegation->evals[op->type];
 
-    if (op->isOperator()) {
+    if (op->isOperator() || extremum) {
         call->append(lisp->provideQuoted(l1->reverse(lisp)));
         Element* e;
         try {
@@ -5157,6 +5402,15 @@ Element* List::evall_scan(LispE* lisp) {
                 }
             }
         }
+
+        //Numerical containers with a basic operator: no call object is needed
+        Element* res = native_scan(lisp, l1, op->type, false);
+        if (res != NULL) {
+            l1->release();
+            op->release();
+            lisp->set_true_as_true();
+            return res;
+        }
     }
     catch (Error* err) {
         lisp->set_true_as_true();
@@ -5473,6 +5727,15 @@ Element* List::evall_backscan(LispE* lisp) {
                 }
             }
         }
+
+        //Numerical containers with a basic operator: no call object is needed
+        Element* res = native_scan(lisp, l1, op->type, true);
+        if (res != NULL) {
+            l1->release();
+            op->release();
+            lisp->set_true_as_true();
+            return res;
+        }
     }
     catch (Error* err) {
         lisp->set_true_as_true();
@@ -9281,13 +9544,19 @@ Element* List::evall_sleep(LispE* lisp) {
 Element* List::evall_sort(LispE* lisp) {
     Element* comparator = liste[1]->eval(lisp);
     Element* container = null_;
-
+    //(sort comparator list true) keeps the order of equal elements
+    bool stable = false;
 
     try {
         //First element is the comparison function OR an operator
         container = liste[2]->eval(lisp);
         if (!container->isList())
             throw new Error(L"Error: the second argument should be a list for 'sort'");
+        if (liste.size() == 4) {
+            Element* e = liste[3]->eval(lisp);
+            stable = e->Boolean();
+            e->release();
+        }
 
         if (comparator->isList()) {
             //It is inevitably a lambda
@@ -9298,6 +9567,14 @@ Element* List::evall_sort(LispE* lisp) {
             //C Is either an atom or an operator
             if (!comparator->isAtom())
                 throw new Error(L"Error: incorrect comparison function in 'sort'");
+            //'<= and '>= give the same order as '< and '>, which are strict as 'sort' requires
+            //and which take the native paths of the typed containers
+            if (comparator->type == l_lowerorequal)
+                comparator = lisp->provideAtom(l_lower);
+            else {
+                if (comparator->type == l_greaterorequal)
+                    comparator = lisp->provideAtom(l_greater);
+            }
         }
     }
     catch (Error* err) {
@@ -9313,7 +9590,7 @@ Element* List::evall_sort(LispE* lisp) {
             complist.append(null_);
             complist.append(null_);
             try {
-                ((Floats*)container)->sorting(lisp, &complist);
+                ((Floats*)container)->sorting(lisp, &complist, stable);
                 comparator->release();
                 return container;
             }
@@ -9329,7 +9606,7 @@ Element* List::evall_sort(LispE* lisp) {
             complist.append(null_);
             complist.append(null_);
             try {
-                ((Numbers*)container)->sorting(lisp, &complist);
+                ((Numbers*)container)->sorting(lisp, &complist, stable);
                 comparator->release();
                 return container;
             }
@@ -9345,7 +9622,7 @@ Element* List::evall_sort(LispE* lisp) {
             complist.append(null_);
             complist.append(null_);
             try {
-                ((Shorts*)container)->sorting(lisp, &complist);
+                ((Shorts*)container)->sorting(lisp, &complist, stable);
                 comparator->release();
                 return container;
             }
@@ -9361,7 +9638,7 @@ Element* List::evall_sort(LispE* lisp) {
             complist.append(null_);
             complist.append(null_);
             try {
-                ((Integers*)container)->sorting(lisp, &complist);
+                ((Integers*)container)->sorting(lisp, &complist, stable);
                 comparator->release();
                 return container;
             }
@@ -9377,7 +9654,7 @@ Element* List::evall_sort(LispE* lisp) {
             complist.append(null_);
             complist.append(null_);
             try {
-                ((Strings*)container)->sorting(lisp, &complist);
+                ((Strings*)container)->sorting(lisp, &complist, stable);
                 comparator->release();
                 return container;
             }
@@ -9406,7 +9683,7 @@ Element* List::evall_sort(LispE* lisp) {
             complist.replacing(1, null_);
             complist.replacing(2, null_);
 
-            l->liste.sorting(lisp, &complist);
+            l->liste.sorting(lisp, &complist, stable);
             comparator->release();
             u_link* it = ((LList*)container)->liste.begin();
             for (long i = 0; i < l->size(); i++) {
@@ -9433,7 +9710,7 @@ Element* List::evall_sort(LispE* lisp) {
             }
             complist.replacing(1, null_);
             complist.replacing(2, null_);
-            l->liste.sorting(lisp, &complist);
+            l->liste.sorting(lisp, &complist, stable);
             comparator->release();
             return container;
         }
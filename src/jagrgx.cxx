@@ -535,6 +535,7 @@ Au_automate::Au_automate(wstring& wrgx) {
 
 Au_automaton::Au_automaton(u_ustring wrgx) {
     first=NULL;
+    dfa=NULL;
     if (!parse(wrgx))
         first = NULL;
 }
@@ -1055,6 +1055,8 @@ Chaine_UTF8::Chaine_UTF8() {
     wvowels[101] = 101;
     wvowels[79] = 79;
     wvowels[89] = 89;
+    
+    ascii_tables();
 }
 
 unsigned char c_utf8_to_unicode(unsigned char* utf, UWCHAR& code) {
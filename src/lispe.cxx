@@ -11,6 +11,7 @@
 
 
 #include <stdio.h>
+#include <chrono>
 #include "lispe.h"
 #include "segmentation.h"
 #include "tools.h"
@@ -398,11 +399,11 @@ void Delegation::initialisation(LispE* lisp) {
     set_instruction(l_signp, "signp", P_TWO, &List::evall_signp);
     set_instruction(l_size, "size", P_TWO, &List::evall_size);
     set_instruction(l_sleep, "sleep", P_TWO, &List::evall_sleep);
-    set_instruction(l_sort, "sort", P_THREE, &List::evall_sort);
+    set_instruction(l_sort, "sort", P_THREE | P_FOUR, &List::evall_sort);
     set_instruction(l_stringp, "stringp", P_TWO, &List::evall_stringp);
     set_instruction(l_strings, "strings", P_ATLEASTONE, &List::evall_strings);
     set_instruction(l_switch, "switch", P_ATLEASTTHREE, &List::evall_switch);
-    set_instruction(l_sum, "sum", P_TWO, &List::evall_sum);
+    set_instruction(l_sum, "sum", P_TWO | P_THREE, &List::evall_sum);
     set_instruction(l_tensor, "tensor", P_ATLEASTTWO, &List::evall_tensor);
     set_instruction(l_tensor_float, "tensor_float", P_ATLEASTTWO, &List::evall_tensor_float);
     set_instruction(l_threadclear, "threadclear", P_ONE | P_TWO, &List::evall_threadclear);
@@ -462,6 +463,8 @@ void Delegation::initialisation(LispE* lisp) {
     set_instruction(l_determinant, "determinant", P_TWO, &List::evall_determinant);
     set_instruction(l_ludcmp, "ludcmp", P_TWO, &List::evall_ludcmp);
     set_instruction(l_lubksb, "lubksb", P_FOUR | P_THREE, &List::evall_lubksb);
+    set_instruction(l_cholesky, "cholesky", P_TWO | P_THREE, &List::evall_cholesky);
+    set_instruction(l_qr, "qr", P_TWO | P_THREE, &List::evall_qr);
     set_instruction(l_iota0, "iota0", P_ATLEASTTWO, &List::evall_iota0);
     set_instruction(l_irank, "irank", P_ATLEASTTHREE, &List::evall_irank);
     set_instruction(l_reduce, "reduce", P_TWO | P_THREE, &List::evall_reduce);
@@ -895,6 +898,191 @@ void Delegation::initialisation(LispE* lisp) {
     
 }
 
+static void pool_recording(LispE* lisp, Dictionary* d, u_ustring key, long sz) {
+    d->recording(key, lisp->provideInteger(sz));
+}
+
+template <class Z> static long pool_trimming(LispE* lisp, Dictionary* d, u_ustring key, vecte<Z>& pool, long nb, bool limits) {
+    if (limits)
+        nb = lisp->pool_size_max(key);
+    long removed = (nb < 0)?0:pool.trim(nb);
+    if (d != NULL)
+        pool_recording(lisp, d, key, removed);
+    return removed;
+}
+
+//We delete the pooled elements beyond nb in each pool
+//and return the total number of deleted elements
+//If d is provided, it records the number of deleted elements for each pool
+//If limits is true, the limit of each pool (see pools_maxsize) replaces nb
+long LispE::trim_pools(long nb, Dictionary* d, bool limits) {
+    if (nb < 0 && !limits)
+        return 0;
+    
+    //Candidates that went back to their pool might be deleted. We cannot collect cycles
+    //here, since trim_pools can be called in the middle of an evaluation
+    if (cycle_candidates.size()) {
+        vector<Element*> pooled;
+        for (auto& e : cycle_candidates) {
+            if (!e->status)
+                pooled.push_back(e);
+        }
+        for (auto& e : pooled)
+            cycle_candidates.erase(e);
+    }
+    
+    long removed = 0;
+    removed += pool_trimming(this, d, U"stack", stack_pool, nb, limits);
+    removed += pool_trimming(this, d, U"return", return_pool, nb, limits);
+    removed += pool_trimming(this, d, U"string", string_pool, nb, limits);
+    removed += pool_trimming(this, d, U"float", float_pool, nb, limits);
+    removed += pool_trimming(this, d, U"number", number_pool, nb, limits);
+    removed += pool_trimming(this, d, U"integer", integer_pool, nb, limits);
+    removed += pool_trimming(this, d, U"numbers", numbers_pool, nb, limits);
+    removed += pool_trimming(this, d, U"floats", floats_pool, nb, limits);
+    removed += pool_trimming(this, d, U"integers", integers_pool, nb, limits);
+    removed += pool_trimming(this, d, U"strings", strings_pool, nb, limits);
+    removed += pool_trimming(this, d, U"list", list_pool, nb, limits);
+    removed += pool_trimming(this, d, U"dictionary", dictionary_pool, nb, limits);
+    removed += pool_trimming(this, d, U"dictionaryi", dictionaryi_pool, nb, limits);
+    removed += pool_trimming(this, d, U"dictionaryn", dictionaryn_pool, nb, limits);
+    removed += pool_trimming(this, d, U"sets", sets_pool, nb, limits);
+    removed += pool_trimming(this, d, U"setn", setn_pool, nb, limits);
+    removed += pool_trimming(this, d, U"seti", seti_pool, nb, limits);
+    removed += pool_trimming(this, d, U"set", set_pool, nb, limits);
+    return removed;
+}
+
+//Returns a dictionary: pool name -> number of elements currently kept in this pool
+Element* LispE::pool_sizes() {
+    Dictionary* d = provideDictionary();
+    pool_recording(this, d, U"stack", stack_pool.size());
+    pool_recording(this, d, U"return", return_pool.size());
+    pool_recording(this, d, U"string", string_pool.size());
+    pool_recording(this, d, U"float", float_pool.size());
+    pool_recording(this, d, U"number", number_pool.size());
+    pool_recording(this, d, U"integer", integer_pool.size());
+    pool_recording(this, d, U"numbers", numbers_pool.size());
+    pool_recording(this, d, U"floats", floats_pool.size());
+    pool_recording(this, d, U"integers", integers_pool.size());
+    pool_recording(this, d, U"strings", strings_pool.size());
+    pool_recording(this, d, U"list", list_pool.size());
+    pool_recording(this, d, U"dictionary", dictionary_pool.size());
+    pool_recording(this, d, U"dictionaryi", dictionaryi_pool.size());
+    pool_recording(this, d, U"dictionaryn", dictionaryn_pool.size());
+    pool_recording(this, d, U"sets", sets_pool.size());
+    pool_recording(this, d, U"setn", setn_pool.size());
+    pool_recording(this, d, U"seti", seti_pool.size());
+    pool_recording(this, d, U"set", set_pool.size());
+    return d;
+}
+
+//------------------------------------------------------------------------------------------
+// Cycle collection
+//------------------------------------------------------------------------------------------
+// This is a synchronous trial deletion, in the spirit of Bacon and Rajan:
+// 1) From each candidate, we visit the graph of collectable containers (pooled lists,
+//    dictionaries and sets, linked lists), and we remove from their reference counter
+//    every reference coming from another visited container.
+// 2) A container whose counter is still positive is referenced from outside (a variable,
+//    a non collectable container...). It is alive, and so is everything it refers to.
+// 3) The remaining containers are only referenced through cycles, they are reclaimed.
+// Linked lists cannot register themselves as candidates, a cycle that only goes through
+// linked lists is not found. seti, setn, sets and the typed lists hold no containers.
+// It is only called at the end of an execution or explicitly, never in threads.
+long LispE::collect_cycles() {
+    if (isThread || nbjoined || cycle_candidates.empty())
+        return 0;
+    
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    
+    std::unordered_map<Element*, long> nodes;
+    vector<Element*> visited;
+    vector<Element*> children;
+    long i;
+    
+    for (auto& e : cycle_candidates) {
+        if (e->status && e->isCollectable() && nodes.find(e) == nodes.end()) {
+            nodes[e] = e->status;
+            visited.push_back(e);
+        }
+    }
+    cycle_candidates.clear();
+    
+    //We remove the internal references
+    for (i = 0; i < visited.size(); i++) {
+        children.clear();
+        visited[i]->collectable_children(children);
+        for (auto& e : children) {
+            if (!e->isCollectable())
+                continue;
+            auto it = nodes.find(e);
+            if (it == nodes.end()) {
+                nodes[e] = e->status - 1;
+                visited.push_back(e);
+            }
+            else
+                it->second--;
+        }
+    }
+    
+    //Containers with external references are alive (a negative value is an
+    //inconsistent counter, we keep the element)
+    vector<Element*> alive;
+    for (auto& a : nodes) {
+        if (a.second) {
+            a.second = 1;
+            alive.push_back(a.first);
+        }
+    }
+    
+    //So is everything that can be reached from them
+    for (i = 0; i < alive.size(); i++) {
+        children.clear();
+        alive[i]->collectable_children(children);
+        for (auto& e : children) {
+            auto it = nodes.find(e);
+            if (it != nodes.end() && !it->second) {
+                it->second = 1;
+                alive.push_back(e);
+            }
+        }
+    }
+    
+    vector<Element*> garbage;
+    for (auto& a : nodes) {
+        if (!a.second)
+            garbage.push_back(a.first);
+    }
+    
+    long bytes = 0;
+    for (auto& e : garbage)
+        bytes += e->collect(nodes);
+    
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    cycle_pause = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    cycle_runs++;
+    cycle_reclaimed += garbage.size();
+    cycle_bytes += bytes;
+    cycle_last_reclaimed = garbage.size();
+    cycle_last_bytes = bytes;
+    return garbage.size();
+}
+
+//Returns a dictionary with the statistics of the last collection and the overall counters
+Element* LispE::cycle_statistics() {
+    Dictionary* d = provideDictionary();
+    pool_recording(this, d, U"reclaimed", cycle_last_reclaimed);
+    pool_recording(this, d, U"bytes", cycle_last_bytes);
+    //in microseconds
+    u_ustring key = U"pause";
+    d->recording(key, provideNumber(cycle_pause));
+    pool_recording(this, d, U"runs", cycle_runs);
+    pool_recording(this, d, U"total_reclaimed", cycle_reclaimed);
+    pool_recording(this, d, U"total_bytes", cycle_bytes);
+    return d;
+}
+
 void LispE::cleaning() {
     if (!isThread) {
         //we force all remaining threads to stop
@@ -981,6 +1169,16 @@ LispE::LispE(LispE* lisp, List* function, List* body) {
 
     //For threads, the stack limit is much smaller
     max_stack_size = 1000;
+    max_pool_size = lisp->max_pool_size;
+    //Cycle collection is not available in threads
+    cycle_threshold = -1;
+    execution_depth = 0;
+    cycle_runs = 0;
+    cycle_reclaimed = 0;
+    cycle_bytes = 0;
+    cycle_last_reclaimed = 0;
+    cycle_last_bytes = 0;
+    cycle_pause = 0;
 
 
     thread_ancestor = lisp;
@@ -999,8 +1197,9 @@ LispE::LispE(LispE* lisp, List* function, List* body) {
 
     //We prepare our stack, with the creation of a local main
     push(delegation->_NULL);
-    //we only copy constant elements...
-    stack_pool[0]->copy(lisp->stack_pool[0]);
+    //we only copy constant elements from the main stack of the caller...
+    //stack_pool only contains recycled elements, which can be trimmed away
+    execution_stack[0]->copy(lisp->execution_stack[0]);
 
     n_null = delegation->_NULL;
     n_true = delegation->_TRUE;
@@ -1062,10 +1261,18 @@ lisp_code LispE::segmenting(string& code, Tokenizer& infos) {
     lisp_code lc;
     string current_line;
     string tampon;
+    u_ustring utoken;
+    short singles[128];
+    memset(singles, -1, sizeof(singles));
+    //Roughly one token every eight bytes
+    infos.reserve(sz >> 3);
     for (i = 0; i < sz; i++) {
         string_end = 187;
         current_i = i;
-        c = getonechar(USTR(code), i);
+        //ASCII characters are read directly
+        c = (uchar)code[i];
+        if (c & 0x80)
+            c = getonechar(USTR(code), i);
         switch (c) {
             case ';':
 			case '#':
@@ -1173,7 +1380,9 @@ lisp_code LispE::segmenting(string& code, Tokenizer& infos) {
                     idx = i + 1;
                     nxt = 0;
                     while (idx < sz) {
-                        nxt = getonechar(USTR(code), idx);
+                        nxt = (uchar)code[idx];
+                        if (nxt & 0x80)
+                            nxt = getonechar(USTR(code), idx);
                         if (nxt == 8220 || (nxt < 172 && stops[nxt]))
                             break;
                         i = idx;
@@ -1200,11 +1409,11 @@ lisp_code LispE::segmenting(string& code, Tokenizer& infos) {
             case '7':
             case '8':
             case '9': {
+                //The number is parsed in place, its token is read from the code buffer
                 double d = convertingfloathexa(code.c_str() + i, idx);
-                tampon = code.substr(i, idx);
                 if (add == true)
-                    current_line += tampon;
-                infos.append(d, tampon, t_number, line_number, i, i + idx);
+                    current_line += code.substr(i, idx);
+                infos.append(d, USTR(code) + i, idx, t_number, line_number, i, i + idx);
                 i += idx - 1;
                 break;
             }
@@ -1259,7 +1468,9 @@ lisp_code LispE::segmenting(string& code, Tokenizer& infos) {
                 nxt = c;
                 while (idx <= sz && nxt != 8220 && (nxt > 171 || !stops[nxt])) {
                     i = idx;
-                    nxt = getonechar(USTR(code), idx);
+                    nxt = (uchar)code[idx];
+                    if (nxt & 0x80)
+                        nxt = getonechar(USTR(code), idx);
                     idx++;
                 }
 
@@ -1300,7 +1511,19 @@ lisp_code LispE::segmenting(string& code, Tokenizer& infos) {
                     }
                 }
 
-                lc = (lisp_code)delegation->check_atom(tampon);
+                if (tampon.size() == 1 && c < 128) {
+                    //single ASCII characters are only checked once
+                    if (singles[c] == -1)
+                        singles[c] = delegation->check_atom(tampon);
+                    lc = (lisp_code)singles[c];
+                    utoken = (u_uchar)c;
+                }
+                else {
+                    //the token is converted once, then moved into infos
+                    utoken.clear();
+                    s_utf8_to_unicode(utoken, USTR(tampon), tampon.size());
+                    lc = (lisp_code)delegation->check_atom(utoken);
+                }
 
                 switch (lc) {
                     case l_composenot:
@@ -1361,9 +1584,9 @@ lisp_code LispE::segmenting(string& code, Tokenizer& infos) {
                     }
                     default:
                         if (lc >= l_plus && lc <= l_concatenate)
-                            infos.append(tampon, t_operator, line_number, current_i, i);
+                            infos.append(utoken, t_operator, line_number, current_i, i);
                         else
-                            infos.append(tampon, t_atom, line_number, current_i, i);
+                            infos.append(utoken, t_atom, line_number, current_i, i);
                 }
 
                 if (i != current_i)
@@ -1644,37 +1867,49 @@ Element* LispE::abstractSyntaxTree(Element* courant, Tokenizer& parse, long& ind
                                     if (nbarguments == 2)
                                         lm = new List_divide2((List*)e);
                                     else
-                                        if (nbarguments == 3)
-                                            lm = new List_divide3((List*)e);
+                                        if (List_fused_arithmetic::fusable(e))
+                                            lm = new List_fused_arithmetic((List*)e);
                                         else
-                                            lm = new List_dividen((List*)e);
+                                            if (nbarguments == 3)
+                                                lm = new List_divide3((List*)e);
+                                            else
+                                                lm = new List_dividen((List*)e);
                                     break;
                                 case l_plus:
                                     if (nbarguments == 2)
                                         lm = new List_plus2((List*)e);
                                     else
-                                        if (nbarguments == 3)
-                                            lm = new List_plus3((List*)e);
+                                        if (List_fused_arithmetic::fusable(e))
+                                            lm = new List_fused_arithmetic((List*)e);
                                         else
-                                            lm = new List_plusn((List*)e);
+                                            if (nbarguments == 3)
+                                                lm = new List_plus3((List*)e);
+                                            else
+                                                lm = new List_plusn((List*)e);
                                     break;
                                 case l_minus:
                                     if (nbarguments == 2)
                                         lm = new List_minus2((List*)e);
                                     else
-                                        if (nbarguments == 3)
-                                            lm = new List_minus3((List*)e);
+                                        if (List_fused_arithmetic::fusable(e))
+                                            lm = new List_fused_arithmetic((List*)e);
                                         else
-                                            lm = new List_minusn((List*)e);
+                                            if (nbarguments == 3)
+                                                lm = new List_minus3((List*)e);
+                                            else
+                                                lm = new List_minusn((List*)e);
                                     break;
                                 case l_multiply:
                                     if (nbarguments == 2)
                                         lm = new List_multiply2((List*)e);
                                     else
-                                        if (nbarguments == 3)
-                                            lm = new List_multiply3((List*)e);
+                                        if (List_fused_arithmetic::fusable(e))
+                                            lm = new List_fused_arithmetic((List*)e);
                                         else
-                                            lm = new List_multiplyn((List*)e);
+                                            if (nbarguments == 3)
+                                                lm = new List_multiply3((List*)e);
+                                            else
+                                                lm = new List_multiplyn((List*)e);
                                     break;
                                 case l_switch:
                                     lm = new Listswitch((Listincode*)e);
@@ -1934,15 +2169,21 @@ Element* LispE::load(string pathname) {
     delegation->updatepathname(pathname);
     delegation->entrypoints[delegation->i_current_file] = delegation->_NULL;
 
+    execution_depth++;
     try {
         Element* tree = compile(code);
         delegation->entrypoints[delegation->i_current_file] = tree;
 
         current_path();
         delegation->reset_context();
-        return tree->eval(this);
+        Element* result = tree->eval(this);
+        execution_depth--;
+        collecting_cycles(result);
+        trimming_pools();
+        return result;
     }
     catch(Error* err) {
+        execution_depth--;
         delegation->forceClean();
         return err;
     }
@@ -2052,10 +2293,17 @@ Element* LispE::execute(string code) {
     delegation->i_current_line = 0;
     delegation->i_current_file = 0;
     clearStop();
+    execution_depth++;
     try {
-        return compile(code)->eval(this);
+        Element* tree = compile(code);
+        Element* result = tree->eval(this);
+        execution_depth--;
+        collecting_cycles(result);
+        trimming_pools();
+        return result;
     }
     catch(Error* err) {
+        execution_depth--;
         delegation->forceClean();
         return err;
     }
@@ -2070,14 +2318,20 @@ Element* LispE::execute(string code, string pathname) {
         delegation->updatepathname(pathname);
     }
 
+    execution_depth++;
     try {
         Element* tree = compile(code);
         delegation->entrypoints[delegation->i_current_file] = tree;
         current_path();
         delegation->reset_context();
-        return tree->eval(this);
+        Element* result = tree->eval(this);
+        execution_depth--;
+        collecting_cycles(result);
+        trimming_pools();
+        return result;
     }
     catch(Error* err) {
+        execution_depth--;
         delegation->forceClean();
         return err;
     }
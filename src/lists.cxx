@@ -14,6 +14,7 @@
 #include "tools.h"
 #include <math.h>
 #include <algorithm>
+#include <thread>
 
 //--------------------------------------------------------------------------------
 //Pools methods
@@ -26,6 +27,8 @@ void Listpool::decrement() {
         liste.clear();
         lisp->list_pool.push_back(this);
     }
+    else
+        lisp->cycle_candidate(this);
 }
 
 void Listpool::decrementstatus(uint16_t nb) {
@@ -36,6 +39,49 @@ void Listpool::decrementstatus(uint16_t nb) {
         liste.clear();
         lisp->list_pool.push_back(this);
     }
+    else
+        lisp->cycle_candidate(this);
+}
+
+//This list is only referenced through cycles (see LispE::collect_cycles)
+//The elements that do not belong to the garbage are released as usual
+long Listpool::collect(std::unordered_map<Element*, long>& nodes) {
+    long bytes = sizeof(Listpool) + liste.item->sz * sizeof(Element*);
+    Element* e;
+    for (long i = 0; i < liste.size(); i++) {
+        e = liste[i];
+        auto it = nodes.find(e);
+        if (it == nodes.end() || it->second)
+            e->decrement();
+    }
+    quoted = 0;
+    status = 0;
+    liste.clear();
+    lisp->list_pool.push_back(this);
+    return bytes;
+}
+
+//Same as above for a linked list, whose links all belong to it (see LList::isCollectable)
+//Linked lists are not pooled, it is deleted
+long LList::collect(std::unordered_map<Element*, long>& nodes) {
+    vector<u_link*> links;
+    u_link* u = liste.begin();
+    while (u != NULL) {
+        links.push_back(u);
+        u = u->next();
+    }
+
+    long bytes = sizeof(LList) + links.size() * sizeof(u_link);
+    for (auto& a : links) {
+        auto it = nodes.find(a->value);
+        if (it == nodes.end() || it->second)
+            a->value->decrement();
+        delete a;
+    }
+    liste.first = NULL;
+    status = 0;
+    delete this;
+    return bytes;
 }
 
 void Listpool::release() {
@@ -177,8 +223,11 @@ Element* Floatspool::copying(bool duplicate) {
 }
 
 Element* Floatspool::copyatom(LispE* lsp, uint16_t s) {
-    if (liste.shared(status) < s)
+    if (liste.shared(status) < s) {
+        //The values are going to be modified in place
+        liste.detach();
         return this;
+    }
     
     Floats* f = lisp->provideFloats(this);
     release();
@@ -230,8 +279,11 @@ Element* Numberspool::copying(bool duplicate) {
 }
 
 Element* Numberspool::copyatom(LispE* lsp, uint16_t s) {
-    if (liste.shared(status) < s)
+    if (liste.shared(status) < s) {
+        //The values are going to be modified in place
+        liste.detach();
         return this;
+    }
     
     Numbers* n = lisp->provideNumbers(this);
     release();
@@ -292,8 +344,11 @@ Element* Integerspool::copying(bool duplicate) {
 }
 
 Element* Integerspool::copyatom(LispE* lsp, uint16_t s) {
-    if (liste.shared(status) < s)
+    if (liste.shared(status) < s) {
+        //The values are going to be modified in place
+        liste.detach();
         return this;
+    }
     
     Integers* i = lisp->provideIntegers(this);
     release();
@@ -350,8 +405,11 @@ Element* Stringspool::copying(bool duplicate) {
 }
 
 Element* Stringspool::copyatom(LispE* lsp, uint16_t s) {
-    if (liste.shared(status) < s)
+    if (liste.shared(status) < s) {
+        //The values are going to be modified in place
+        liste.detach();
         return this;
+    }
     
     return lisp->provideStrings(this);
 }
@@ -372,16 +430,17 @@ Element* Pair::cdr(LispE* lisp) {
 }
 
 //------------------------------------------------------------------------------------------
+//The elements are quoted once before sorting (see LIST::sorting below), the call
+//only receives their pointers
 inline bool LIST::compare(LispE* lisp, List* comparison, short instruction, long i, long j) {
-    comparison->liste[1] = item->buffer[i]->quoting();
-    comparison->liste[2] = item->buffer[j]->quoting();
-    bool r = comparison->eval_Boolean(lisp, instruction);
-    comparison->liste[1]->release();
-    comparison->liste[2]->release();
-    return r;
+    comparison->liste[1] = item->buffer[i];
+    comparison->liste[2] = item->buffer[j];
+    return comparison->eval_Boolean(lisp, instruction);
 }
 
-void LIST::sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax) {
+//Introsort: a quicksort with a median of three pivot, which falls back to a heap sort
+//when the partitions get too unbalanced (depth is 2.log2(n) at the beginning)
+void LIST::sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax, long depth) {
     //(setq s (sort '< (shuffle (cons 5 (range 1 99999 1)))))
     //(sort '< '(28 60 10 38 80 34 8 22 78 68 85 48 13 39 100 56 89 82 11 52 99 50 20 96 97 59 23 81 53 15 3 67 77 7 57 74 49 32 86 66 43 26 75 62 29 71 2 91 51 1 18 12 24 21 36 72 90 40 70 14 61 93 6 4 79 94 47 58 30 83 84 44 88 63 95 45 33 65 37 92 27 64 55 9 31 73 54 16 98 5 46 25 76 42 17 69 19 35 5 41 87))
     //(sort '< '(20 12 15 13 19 17 14))
@@ -439,6 +498,21 @@ void LIST::sorting(LispE* lisp, List* comparison, short instruction, long rmin,
         return;
     }
     
+    if (!depth) {
+        heap_sorting(lisp, comparison, instruction, rmin, rmax);
+        return;
+    }
+    depth--;
+    
+    //The median of rmin, the middle and rmax is moved into rmax
+    pivot = rmin + (j >> 1);
+    if (compare(lisp, comparison, instruction, pivot, rmin))
+        item->swap(pivot, rmin);
+    if (compare(lisp, comparison, instruction, rmax, rmin))
+        item->swap(rmax, rmin);
+    if (compare(lisp, comparison, instruction, pivot, rmax))
+        item->swap(pivot, rmax);
+    
     pivot = rmin - 1;
     comparison->liste[2] = item->buffer[rmax];
     for (j = rmin; j < rmax; j++) {
@@ -451,17 +525,95 @@ void LIST::sorting(LispE* lisp, List* comparison, short instruction, long rmin,
     pivot++;
     item->swap(pivot, rmax);
     
-    sorting(lisp, comparison, instruction, rmin, pivot-1);
-    sorting(lisp, comparison, instruction, pivot+1, rmax);
+    sorting(lisp, comparison, instruction, rmin, pivot-1, depth);
+    sorting(lisp, comparison, instruction, pivot+1, rmax, depth);
+}
+
+void LIST::sifting(LispE* lisp, List* comparison, short instruction, long base, long root, long nb) {
+    long child;
+    while ((child = 2 * root + 1) < nb) {
+        if (child + 1 < nb && compare(lisp, comparison, instruction, base + child, base + child + 1))
+            child++;
+        if (!compare(lisp, comparison, instruction, base + root, base + child))
+            return;
+        item->swap(base + root, base + child);
+        root = child;
+    }
+}
+
+void LIST::heap_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax) {
+    long nb = rmax - rmin + 1;
+    long i;
+    for (i = nb / 2 - 1; i >= 0; i--)
+        sifting(lisp, comparison, instruction, rmin, i, nb);
+    for (i = nb - 1; i > 0; i--) {
+        item->swap(rmin, rmin + i);
+        sifting(lisp, comparison, instruction, rmin, 0, i);
+    }
+}
+
+//Merge sort: elements are only moved when the right one is strictly lower than the left one
+//Each merge is written into buffer before being copied back, hence an error in the comparison
+//leaves the list with all its elements
+void LIST::stable_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax, Element** buffer) {
+    long nb = rmax - rmin + 1;
+    long i, j;
+    if (nb < 8) {
+        for (i = rmin + 1; i <= rmax; i++) {
+            for (j = i; j > rmin && compare(lisp, comparison, instruction, j, j - 1); j--)
+                item->swap(j, j - 1);
+        }
+        return;
+    }
+    
+    long middle = rmin + (nb >> 1);
+    stable_sorting(lisp, comparison, instruction, rmin, middle - 1, buffer);
+    stable_sorting(lisp, comparison, instruction, middle, rmax, buffer);
+    
+    //already in order
+    if (!compare(lisp, comparison, instruction, middle, middle - 1))
+        return;
+    
+    long k = 0;
+    i = rmin;
+    j = middle;
+    while (i < middle && j <= rmax) {
+        if (compare(lisp, comparison, instruction, j, i))
+            buffer[k++] = item->buffer[j++];
+        else
+            buffer[k++] = item->buffer[i++];
+    }
+    while (i < middle)
+        buffer[k++] = item->buffer[i++];
+    while (j <= rmax)
+        buffer[k++] = item->buffer[j++];
+    memcpy(item->buffer + rmin, buffer, nb * sizeof(Element*));
 }
 
-void LIST::sorting(LispE* lisp, List* comparison) {
+void LIST::sorting(LispE* lisp, List* comparison, bool stable) {
     //We sort between home and last...
     long sz = item->last - home;
     if (sz <= 1)
         return;
     
-    sorting(lisp, comparison, comparison->liste[0]->type, home, item->last - 1);
+    //Elements are quoted, otherwise a list would be evaluated as a function call
+    for (long i = home; i < item->last; i++)
+        item->buffer[i]->quoting();
+    
+    if (stable) {
+        Element** buffer = new Element*[sz];
+        try {
+            stable_sorting(lisp, comparison, comparison->liste[0]->type, home, item->last - 1, buffer);
+        }
+        catch (Error* err) {
+            delete[] buffer;
+            throw err;
+        }
+        delete[] buffer;
+        return;
+    }
+    
+    sorting(lisp, comparison, comparison->liste[0]->type, home, item->last - 1, 2 * (long)log2(sz));
 }
 
 //------------------------------------------------------------------------------------------
@@ -2702,7 +2854,7 @@ template <class Z> bool vecte_a<Z>::compare(LispE* lisp, List* comparison, short
     return comparison->eval_Boolean(lisp, instruction);
 }
 
-template <class Z>void vecte_a<Z>::values_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax) {
+template <class Z> void vecte_a<Z>::values_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax, long depth) {
     //(setq s (sort '< (shuffle (cons 5 (range 1 99999 1)))))
     //(sort '< '(28 60 10 38 80 34 8 22 78 68 85 48 13 39 100 56 89 82 11 52 99 50 20 96 97 59 23 81 53 15 3 67 77 7 57 74 49 32 86 66 43 26 75 62 29 71 2 91 51 1 18 12 24 21 36 72 90 40 70 14 61 93 6 4 79 94 47 58 30 83 84 44 88 63 95 45 33 65 37 92 27 64 55 9 31 73 54 16 98 5 46 25 76 42 17 69 19 35 5 41 87))
     //(sort '< '(20 12 15 13 19 17 14))
@@ -2760,6 +2912,21 @@ template <class Z>void vecte_a<Z>::values_sorting(LispE* lisp, List* comparison,
         return;
     }
     
+    if (!depth) {
+        values_heap_sorting(lisp, comparison, instruction, rmin, rmax);
+        return;
+    }
+    depth--;
+    
+    //The median of rmin, the middle and rmax is moved into rmax
+    pivot = rmin + (j >> 1);
+    if (compare(lisp, comparison, instruction, pivot, rmin))
+        swap(pivot, rmin);
+    if (compare(lisp, comparison, instruction, rmax, rmin))
+        swap(rmax, rmin);
+    if (compare(lisp, comparison, instruction, pivot, rmax))
+        swap(pivot, rmax);
+    
     pivot = rmin - 1;
     comparison->liste[2]->setvalue(items->buffer[rmax]);
     for (j = rmin; j < rmax; j++) {
@@ -2772,8 +2939,85 @@ template <class Z>void vecte_a<Z>::values_sorting(LispE* lisp, List* comparison,
     pivot++;
     swap(pivot, rmax);
     
-    values_sorting(lisp, comparison, instruction, rmin, pivot-1);
-    values_sorting(lisp, comparison, instruction, pivot+1, rmax);
+    values_sorting(lisp, comparison, instruction, rmin, pivot-1, depth);
+    values_sorting(lisp, comparison, instruction, pivot+1, rmax, depth);
+}
+
+template <class Z> void vecte_a<Z>::values_sifting(LispE* lisp, List* comparison, short instruction, long base, long root, long nb) {
+    long child;
+    while ((child = 2 * root + 1) < nb) {
+        if (child + 1 < nb && compare(lisp, comparison, instruction, base + child, base + child + 1))
+            child++;
+        if (!compare(lisp, comparison, instruction, base + root, base + child))
+            return;
+        swap(base + root, base + child);
+        root = child;
+    }
+}
+
+template <class Z> void vecte_a<Z>::values_heap_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax) {
+    long nb = rmax - rmin + 1;
+    long i;
+    for (i = nb / 2 - 1; i >= 0; i--)
+        values_sifting(lisp, comparison, instruction, rmin, i, nb);
+    for (i = nb - 1; i > 0; i--) {
+        swap(rmin, rmin + i);
+        values_sifting(lisp, comparison, instruction, rmin, 0, i);
+    }
+}
+
+//Merge sort, see LIST::stable_sorting
+template <class Z> void vecte_a<Z>::values_stable_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax, Z* buffer) {
+    long nb = rmax - rmin + 1;
+    long i, j;
+    if (nb < 8) {
+        for (i = rmin + 1; i <= rmax; i++) {
+            for (j = i; j > rmin && compare(lisp, comparison, instruction, j, j - 1); j--)
+                swap(j, j - 1);
+        }
+        return;
+    }
+    
+    long middle = rmin + (nb >> 1);
+    values_stable_sorting(lisp, comparison, instruction, rmin, middle - 1, buffer);
+    values_stable_sorting(lisp, comparison, instruction, middle, rmax, buffer);
+    
+    if (!compare(lisp, comparison, instruction, middle, middle - 1))
+        return;
+    
+    long k = 0;
+    i = rmin;
+    j = middle;
+    while (i < middle && j <= rmax) {
+        if (compare(lisp, comparison, instruction, j, i))
+            buffer[k++] = items->buffer[j++];
+        else
+            buffer[k++] = items->buffer[i++];
+    }
+    while (i < middle)
+        buffer[k++] = items->buffer[i++];
+    while (j <= rmax)
+        buffer[k++] = items->buffer[j++];
+    for (k = 0; k < nb; k++)
+        items->buffer[rmin + k] = buffer[k];
+}
+
+template <class Z> void vecte_a<Z>::values_sorting(LispE* lisp, List* comparison, bool stable) {
+    long sz = size();
+    if (stable) {
+        Z* buffer = new Z[sz];
+        try {
+            values_stable_sorting(lisp, comparison, comparison->liste[0]->type, home, home + sz - 1, buffer);
+        }
+        catch (Error* err) {
+            delete[] buffer;
+            throw err;
+        }
+        delete[] buffer;
+        return;
+    }
+    
+    values_sorting(lisp, comparison, comparison->liste[0]->type, home, home + sz - 1, 2 * (long)log2(sz));
 }
 
 //--------------------------------------------------------------------------------
@@ -2784,7 +3028,7 @@ template <class Z> bool vecte_n<Z>::compare(LispE* lisp, List* comparison, short
     return comparison->eval_Boolean(lisp, instruction);
 }
 
-template <class Z> void vecte_n<Z>::values_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax) {
+template <class Z> void vecte_n<Z>::values_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax, long depth) {
     //(setq s (sort '< (shuffle (cons 5 (range 1 99999 1)))))
     //(sort '< '(28 60 10 38 80 34 8 22 78 68 85 48 13 39 100 56 89 82 11 52 99 50 20 96 97 59 23 81 53 15 3 67 77 7 57 74 49 32 86 66 43 26 75 62 29 71 2 91 51 1 18 12 24 21 36 72 90 40 70 14 61 93 6 4 79 94 47 58 30 83 84 44 88 63 95 45 33 65 37 92 27 64 55 9 31 73 54 16 98 5 46 25 76 42 17 69 19 35 5 41 87))
     //(sort '< '(20 12 15 13 19 17 14))
@@ -2842,6 +3086,21 @@ template <class Z> void vecte_n<Z>::values_sorting(LispE* lisp, List* comparison
         return;
     }
     
+    if (!depth) {
+        values_heap_sorting(lisp, comparison, instruction, rmin, rmax);
+        return;
+    }
+    depth--;
+    
+    //The median of rmin, the middle and rmax is moved into rmax
+    pivot = rmin + (j >> 1);
+    if (compare(lisp, comparison, instruction, pivot, rmin))
+        swap(pivot, rmin);
+    if (compare(lisp, comparison, instruction, rmax, rmin))
+        swap(rmax, rmin);
+    if (compare(lisp, comparison, instruction, pivot, rmax))
+        swap(pivot, rmax);
+    
     pivot = rmin - 1;
     comparison->liste[2]->setvalue(items->buffer[rmax]);
     for (j = rmin; j < rmax; j++) {
@@ -2854,10 +3113,263 @@ template <class Z> void vecte_n<Z>::values_sorting(LispE* lisp, List* comparison
     pivot++;
     swap(pivot, rmax);
     
-    values_sorting(lisp, comparison, instruction, rmin, pivot-1);
-    values_sorting(lisp, comparison, instruction, pivot+1, rmax);
+    values_sorting(lisp, comparison, instruction, rmin, pivot-1, depth);
+    values_sorting(lisp, comparison, instruction, pivot+1, rmax, depth);
 }
 
+template <class Z> void vecte_n<Z>::values_sifting(LispE* lisp, List* comparison, short instruction, long base, long root, long nb) {
+    long child;
+    while ((child = 2 * root + 1) < nb) {
+        if (child + 1 < nb && compare(lisp, comparison, instruction, base + child, base + child + 1))
+            child++;
+        if (!compare(lisp, comparison, instruction, base + root, base + child))
+            return;
+        swap(base + root, base + child);
+        root = child;
+    }
+}
+
+template <class Z> void vecte_n<Z>::values_heap_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax) {
+    long nb = rmax - rmin + 1;
+    long i;
+    for (i = nb / 2 - 1; i >= 0; i--)
+        values_sifting(lisp, comparison, instruction, rmin, i, nb);
+    for (i = nb - 1; i > 0; i--) {
+        swap(rmin, rmin + i);
+        values_sifting(lisp, comparison, instruction, rmin, 0, i);
+    }
+}
+
+//Merge sort, see LIST::stable_sorting
+template <class Z> void vecte_n<Z>::values_stable_sorting(LispE* lisp, List* comparison, short instruction, long rmin, long rmax, Z* buffer) {
+    long nb = rmax - rmin + 1;
+    long i, j;
+    if (nb < 8) {
+        for (i = rmin + 1; i <= rmax; i++) {
+            for (j = i; j > rmin && compare(lisp, comparison, instruction, j, j - 1); j--)
+                swap(j, j - 1);
+        }
+        return;
+    }
+    
+    long middle = rmin + (nb >> 1);
+    values_stable_sorting(lisp, comparison, instruction, rmin, middle - 1, buffer);
+    values_stable_sorting(lisp, comparison, instruction, middle, rmax, buffer);
+    
+    if (!compare(lisp, comparison, instruction, middle, middle - 1))
+        return;
+    
+    long k = 0;
+    i = rmin;
+    j = middle;
+    while (i < middle && j <= rmax) {
+        if (compare(lisp, comparison, instruction, j, i))
+            buffer[k++] = items->buffer[j++];
+        else
+            buffer[k++] = items->buffer[i++];
+    }
+    while (i < middle)
+        buffer[k++] = items->buffer[i++];
+    while (j <= rmax)
+        buffer[k++] = items->buffer[j++];
+    for (k = 0; k < nb; k++)
+        items->buffer[rmin + k] = buffer[k];
+}
+
+template <class Z> void vecte_n<Z>::values_sorting(LispE* lisp, List* comparison, bool stable) {
+    long sz = size();
+    if (stable) {
+        Z* buffer = new Z[sz];
+        try {
+            values_stable_sorting(lisp, comparison, comparison->liste[0]->type, home, home + sz - 1, buffer);
+        }
+        catch (Error* err) {
+            delete[] buffer;
+            throw err;
+        }
+        delete[] buffer;
+        return;
+    }
+    
+    values_sorting(lisp, comparison, comparison->liste[0]->type, home, home + sz - 1, 2 * (long)log2(sz));
+}
+
+//--------------------------------------------------------------------------------
+//Native sorting of typed containers with '<' or '>'
+//Numerical values are sorted with a LSD radix sort on their bit patterns, strings with
+//a multikey quicksort. Above sort_threading values, slices are sorted in parallel
+//and then merged
+//--------------------------------------------------------------------------------
+const long sort_threading = 1 << 20;
+
+//Number of slices sorted in parallel, 0 means one slice per hardware thread
+//It can be forced to check the merge of the slices (see check/checksort.cxx)
+long sort_slices = 0;
+
+//The bit patterns are transformed so that their unsigned order is the numerical order
+static inline uint64_t radix_key(long v) {
+    return (uint64_t)v ^ 0x8000000000000000ULL;
+}
+
+static inline uint16_t radix_key(short v) {
+    return (uint16_t)v ^ 0x8000;
+}
+
+static inline uint64_t radix_key(double v) {
+    uint64_t u;
+    memcpy(&u, &v, sizeof(double));
+    return (u & 0x8000000000000000ULL)?~u:(u | 0x8000000000000000ULL);
+}
+
+static inline uint32_t radix_key(float v) {
+    uint32_t u;
+    memcpy(&u, &v, sizeof(float));
+    return (u & 0x80000000)?~u:(u | 0x80000000);
+}
+
+//8 bits per pass, the passes on bytes that are the same for all values are skipped
+template <class Z> static void radix_sort(Z* values, long nb, Z* buffer) {
+    const long nbpasses = sizeof(radix_key(values[0]));
+    std::vector<long> counts(nbpasses << 8, 0);
+    long i, p;
+    
+    for (i = 0; i < nb; i++) {
+        auto k = radix_key(values[i]);
+        for (p = 0; p < nbpasses; p++)
+            counts[(p << 8) + ((k >> (p << 3)) & 0xFF)]++;
+    }
+    
+    Z* source = values;
+    Z* target = buffer;
+    Z* tmp;
+    long* count;
+    long total, c;
+    for (p = 0; p < nbpasses; p++) {
+        count = counts.data() + (p << 8);
+        if (count[(radix_key(values[0]) >> (p << 3)) & 0xFF] == nb)
+            continue;
+        
+        total = 0;
+        for (i = 0; i < 256; i++) {
+            c = count[i];
+            count[i] = total;
+            total += c;
+        }
+        for (i = 0; i < nb; i++)
+            target[count[(radix_key(source[i]) >> (p << 3)) & 0xFF]++] = source[i];
+        tmp = source;
+        source = target;
+        target = tmp;
+    }
+    
+    if (source != values)
+        memcpy(values, source, nb * sizeof(Z));
+}
+
+static inline long radix_char(u_ustring& s, long depth) {
+    return (depth < s.size())?(long)s[depth]:-1;
+}
+
+//Multikey quicksort (Bentley and Sedgewick): strings are partitioned on their character at depth
+static void radix_sort(u_ustring* values, long nb, long depth) {
+    long i, j, lt, gt;
+    long v, c;
+    while (nb > 1) {
+        if (nb < 16) {
+            for (i = 1; i < nb; i++) {
+                for (j = i; j > 0 && values[j].compare(depth, u_ustring::npos, values[j - 1], depth, u_ustring::npos) < 0; j--)
+                    values[j].swap(values[j - 1]);
+            }
+            return;
+        }
+        
+        values[0].swap(values[nb >> 1]);
+        v = radix_char(values[0], depth);
+        lt = 0;
+        gt = nb - 1;
+        i = 1;
+        while (i <= gt) {
+            c = radix_char(values[i], depth);
+            if (c < v)
+                values[lt++].swap(values[i++]);
+            else {
+                if (c > v)
+                    values[i].swap(values[gt--]);
+                else
+                    i++;
+            }
+        }
+        
+        radix_sort(values, lt, depth);
+        radix_sort(values + gt + 1, nb - gt - 1, depth);
+        if (v == -1)
+            return;
+        values += lt;
+        nb = gt - lt + 1;
+        depth++;
+    }
+}
+
+template <class Z> static void radix_slice(Z* values, long nb, Z* buffer) {
+    radix_sort(values, nb, buffer);
+}
+
+static void radix_slice(u_ustring* values, long nb, u_ustring* buffer) {
+    radix_sort(values, nb, 0);
+}
+
+//The slices are merged with the same order as the radix sort
+template <class Z> static bool radix_lower(const Z& a, const Z& b) {
+    return (radix_key(a) < radix_key(b));
+}
+
+static bool radix_lower(const u_ustring& a, const u_ustring& b) {
+    return (a < b);
+}
+
+template <class Z> static void native_sorting(Z* values, long nb, bool descending) {
+    Z* buffer = new Z[nb];
+    long nbthreads = sort_slices?sort_slices:std::thread::hardware_concurrency();
+    if (nbthreads <= 1 || nb < sort_threading)
+        radix_slice(values, nb, buffer);
+    else {
+        //Each thread sorts its own slice, the slices are then merged two by two
+        void (*slicing)(Z*, long, Z*) = radix_slice;
+        bool (*lower)(const Z&, const Z&) = radix_lower;
+        vecte<std::thread*> threads;
+        std::vector<long> bounds;
+        long slice = (nb + nbthreads - 1) / nbthreads;
+        long i;
+        for (i = 0; i < nb; i += slice) {
+            bounds.push_back(i);
+            threads.push_back(new std::thread(slicing, values + i, std::min(slice, nb - i), buffer + i));
+        }
+        bounds.push_back(nb);
+        for (i = 0; i < threads.size(); i++) {
+            threads[i]->join();
+            delete threads[i];
+        }
+        
+        long b;
+        while (bounds.size() > 2) {
+            std::vector<long> merged;
+            for (b = 0; b + 2 < bounds.size(); b += 2) {
+                std::inplace_merge(values + bounds[b], values + bounds[b + 1], values + bounds[b + 2], lower);
+                merged.push_back(bounds[b]);
+            }
+            merged.push_back(bounds[b]);
+            if (b + 1 < bounds.size())
+                merged.push_back(nb);
+            bounds = merged;
+        }
+    }
+    delete[] buffer;
+    
+    if (descending)
+        std::reverse(values, values + nb);
+}
+
+
 //--------------------------------------------------------------------------------
 //Numbers methods
 //--------------------------------------------------------------------------------
@@ -2881,12 +3393,15 @@ Element* Numbers::check_member(LispE* lisp, Element* the_set) {
     return n;
 }
 
-void Numbers::sorting(LispE* lisp, List* comparison) {
+void Numbers::sorting(LispE* lisp, List* comparison, bool stable) {
     //We sort between home and last...
     long sz = size();
     if (sz <= 1)
         return;
     
+    //The values are sorted in place
+    liste.detach();
+    
     Constnumber n1(0);
     Constnumber n2(0);
     comparison->liste[1] = &n1;
@@ -2897,7 +3412,12 @@ void Numbers::sorting(LispE* lisp, List* comparison) {
     if (comparison->eval(lisp)->Boolean())
         throw new Error(L"Error: The comparison must be strict for a 'sort': (comp a a) must return 'nil'.");
     
-    liste.values_sorting(lisp, comparison, comparison->liste[0]->type, 0, sz-1);
+    if (comparison->liste[0]->type == l_lower || comparison->liste[0]->type == l_greater) {
+        native_sorting(liste.items->buffer + liste.home, sz, comparison->liste[0]->type == l_greater);
+        return;
+    }
+    
+    liste.values_sorting(lisp, comparison, stable);
 }
 
 Element* Numbers::minimum(LispE* lisp) {
@@ -2960,7 +3480,7 @@ void Numbers::storevalue(LispE* lisp, u_ustring& s) {
 
 Element* Numbers::invert_sign(LispE* lisp) {
     Numbers* n = this;
-    if (status)
+    if (liste.shared(status))
         n = lisp->provideNumbers(this);
     
     for (long i = 0; i < n->liste.size(); i++)
@@ -3475,12 +3995,15 @@ Element* Integers::check_member(LispE* lisp, Element* the_set) {
     return n;
 }
 
-void Integers::sorting(LispE* lisp, List* comparison) {
+void Integers::sorting(LispE* lisp, List* comparison, bool stable) {
     //We sort between home and last...
     long sz = size();
     if (sz <= 1)
         return;
     
+    //The values are sorted in place
+    liste.detach();
+    
     Constinteger n1(0);
     Constinteger n2(0);
     comparison->liste[1] = &n1;
@@ -3490,7 +4013,12 @@ void Integers::sorting(LispE* lisp, List* comparison) {
     if (comparison->eval(lisp)->Boolean())
         throw new Error(L"Error: The comparison must be strict for a 'sort': (comp a a) must return 'nil'.");
     
-    liste.values_sorting(lisp, comparison, comparison->liste[0]->type, 0, sz-1);
+    if (comparison->liste[0]->type == l_lower || comparison->liste[0]->type == l_greater) {
+        native_sorting(liste.items->buffer + liste.home, sz, comparison->liste[0]->type == l_greater);
+        return;
+    }
+    
+    liste.values_sorting(lisp, comparison, stable);
 }
 
 Element* Integers::minimum(LispE* lisp) {
@@ -3550,7 +4078,7 @@ void Integers::storevalue(LispE* lisp, u_ustring& s) {
 
 Element* Integers::invert_sign(LispE* lisp) {
     Integers* n = this;
-    if (status)
+    if (liste.shared(status))
         n = lisp->provideIntegers(this);
     
     for (long i = 0; i < n->liste.size(); i++)
@@ -4069,12 +4597,15 @@ Element* Strings::check_member(LispE* lisp, Element* the_set) {
 }
 
 
-void Strings::sorting(LispE* lisp, List* comparison) {
+void Strings::sorting(LispE* lisp, List* comparison, bool stable) {
     //We sort between home and last...
     long sz = size();
     if (sz <= 1)
         return;
     
+    //The values are sorted in place
+    liste.detach();
+    
     Conststring n1(U"");
     Conststring n2(U"");
     comparison->liste[1] = &n1;
@@ -4084,7 +4615,12 @@ void Strings::sorting(LispE* lisp, List* comparison) {
     if (comparison->eval(lisp)->Boolean())
         throw new Error(L"Error: The comparison must be strict for a 'sort': (comp a a) must return 'nil'.");
     
-    liste.values_sorting(lisp, comparison, comparison->liste[0]->type, 0, sz-1);
+    if (comparison->liste[0]->type == l_lower || comparison->liste[0]->type == l_greater) {
+        native_sorting(liste.items->buffer + liste.home, sz, comparison->liste[0]->type == l_greater);
+        return;
+    }
+    
+    liste.values_sorting(lisp, comparison, stable);
 }
 
 Element* Strings::minimum(LispE* lisp) {
@@ -4491,6 +5027,7 @@ Element* Strings::plus(LispE* lisp, Element* e) {
         u_ustring d = liste.sum();
         return lisp->provideString(d);
     }
+    liste.detach();
     if (e->isList()) {
         for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] += e->index(i)->asUString(lisp);
@@ -4994,12 +5531,15 @@ Element* Shorts::check_member(LispE* lisp, Element* the_set) {
     return n;
 }
 
-void Shorts::sorting(LispE* lisp, List* comparison) {
+void Shorts::sorting(LispE* lisp, List* comparison, bool stable) {
     //We sort between home and last...
     long sz = size();
     if (sz <= 1)
         return;
     
+    //The values are sorted in place
+    liste.detach();
+    
     Constshort n1(0);
     Constshort n2(0);
     comparison->liste[1] = &n1;
@@ -5009,7 +5549,12 @@ void Shorts::sorting(LispE* lisp, List* comparison) {
     if (comparison->eval(lisp)->Boolean())
         throw new Error(L"Error: The comparison must be strict for a 'sort': (comp a a) must return 'nil'.");
     
-    liste.values_sorting(lisp, comparison, comparison->liste[0]->type, 0, sz-1);
+    if (comparison->liste[0]->type == l_lower || comparison->liste[0]->type == l_greater) {
+        native_sorting(liste.items->buffer + liste.home, sz, comparison->liste[0]->type == l_greater);
+        return;
+    }
+    
+    liste.values_sorting(lisp, comparison, stable);
 }
 
 Element* Shorts::minimum(LispE* lisp) {
@@ -5069,7 +5614,7 @@ void Shorts::storevalue(LispE* lisp, u_ustring& s) {
 
 Element* Shorts::invert_sign(LispE* lisp) {
     Shorts* n = this;
-    if (status)
+    if (liste.shared(status))
         n = new Shorts(this);
     
     for (long i = 0; i < n->liste.size(); i++)
@@ -5587,12 +6132,15 @@ Element* Floats::check_member(LispE* lisp, Element* the_set) {
     return n;
 }
 
-void Floats::sorting(LispE* lisp, List* comparison) {
+void Floats::sorting(LispE* lisp, List* comparison, bool stable) {
     //We sort between home and last...
     long sz = size();
     if (sz <= 1)
         return;
     
+    //The values are sorted in place
+    liste.detach();
+    
     Constfloat n1(0);
     Constfloat n2(0);
     comparison->liste[1] = &n1;
@@ -5603,7 +6151,12 @@ void Floats::sorting(LispE* lisp, List* comparison) {
     if (comparison->eval(lisp)->Boolean())
         throw new Error(L"Error: The comparison must be strict for a 'sort': (comp a a) must return 'nil'.");
     
-    liste.values_sorting(lisp, comparison, comparison->liste[0]->type, 0, sz-1);
+    if (comparison->liste[0]->type == l_lower || comparison->liste[0]->type == l_greater) {
+        native_sorting(liste.items->buffer + liste.home, sz, comparison->liste[0]->type == l_greater);
+        return;
+    }
+    
+    liste.values_sorting(lisp, comparison, stable);
 }
 
 Element* Floats::minimum(LispE* lisp) {
@@ -5672,7 +6225,7 @@ void Floats::storevalue(LispE* lisp, u_ustring& s) {
 
 Element* Floats::invert_sign(LispE* lisp) {
     Floats* n = this;
-    if (status)
+    if (liste.shared(status))
         n = lisp->provideFloats(this);
     
     for (long i = 0; i < n->liste.size(); i++)
@@ -6186,17 +6739,12 @@ Element* Matrice::check_member(LispE* lisp,Element* the_set) {
 }
 
 Element* Matrice::transposed(LispE* lisp) {
-    Matrice* transposed_matrix = new Matrice(lisp, size_y, size_x, 0.0);
-    long i, j = 0;
-    
-    Element* e;
-    for (i = 0; i < size_x; i++) {
-        e = liste[i];
-        for (j = 0; j < size_y; j++) {
-            transposed_matrix->index(j)->replacing(i, e->index(j));
-        }
-    }
-    return transposed_matrix;
+    //The transposition is a view on a dense copy of the matrix
+    //The final copy into rows is done by blocks
+    dense_matrix<double> m(size_x, size_y);
+    dense(m);
+    m.transpose();
+    return new Matrice(lisp, m);
 }
 
 Element* Matrice::rank(LispE* lisp, vecte<long>& positions) {
@@ -6303,17 +6851,12 @@ Element* Matrice_float::check_member(LispE* lisp, Element* the_set) {
 }
 
 Element* Matrice_float::transposed(LispE* lisp) {
-    Matrice_float* transposed_matrix = new Matrice_float(lisp, size_y, size_x, 0.0);
-    long i, j = 0;
-    
-    Element* e;
-    for (i = 0; i < size_x; i++) {
-        e = liste[i];
-        for (j = 0; j < size_y; j++) {
-            transposed_matrix->index(j)->replacing(i, e->index(j));
-        }
-    }
-    return transposed_matrix;
+    //The transposition is a view on a dense copy of the matrix
+    //The final copy into rows is done by blocks
+    dense_matrix<float> m(size_x, size_y);
+    dense(m);
+    m.transpose();
+    return new Matrice_float(lisp, m);
 }
 
 Element* Matrice_float::rank(LispE* lisp, vecte<long>& positions) {
@@ -19,6 +19,8 @@
 #include "tools.h"
 #include "vecte.h"
 #include <algorithm>
+#include <thread>
+#include <limits>
 
 #ifdef WIN32
 #define _USE_MATH_DEFINES
@@ -216,6 +218,39 @@ Matrice::Matrice(LispE* lisp, long x, long y, double n) {
     }
 }
 
+Matrice::Matrice(LispE* lisp, dense_matrix<double>& m) {
+    type = t_matrix;
+    size_x = m.size_x;
+    size_y = m.size_y;
+    double** rows = new double*[size_x];
+    Numbers* l;
+    for (long i = 0; i < size_x; i++) {
+        l = lisp->provideNumbers(size_y, 0);
+        rows[i] = l->liste.items->buffer + l->liste.home;
+        append(l);
+    }
+    m.copy_into(rows);
+    delete[] rows;
+}
+
+//A row might have been replaced with another list (see set@), which is then read element by element
+void Matrice::dense(dense_matrix<double>& m) {
+    Element* e;
+    double* r;
+    for (long i = 0; i < size_x; i++) {
+        e = liste[i];
+        if (e->size() != size_y)
+            throw new Error("Error: matrix rows should all have the same size");
+        if (e->type == t_numbers) {
+            memcpy(m.row(i), ((Numbers*)e)->liste.items->buffer + ((Numbers*)e)->liste.home, sizeof(double)*size_y);
+            continue;
+        }
+        r = m.row(i);
+        for (long j = 0; j < size_y; j++)
+            r[j] = e->index(j)->asNumber();
+    }
+}
+
 void Matrice::build(LispE* lisp, Element* lst) {
     Numbers* l;
     long idx = 0;
@@ -266,6 +301,39 @@ Matrice_float::Matrice_float(LispE* lisp, long x, long y, float n) {
     }
 }
 
+Matrice_float::Matrice_float(LispE* lisp, dense_matrix<float>& m) {
+    type = t_matrix_float;
+    size_x = m.size_x;
+    size_y = m.size_y;
+    float** rows = new float*[size_x];
+    Floats* l;
+    for (long i = 0; i < size_x; i++) {
+        l = lisp->provideFloats(size_y, 0);
+        rows[i] = l->liste.items->buffer + l->liste.home;
+        append(l);
+    }
+    m.copy_into(rows);
+    delete[] rows;
+}
+
+//A row might have been replaced with another list (see set@), which is then read element by element
+void Matrice_float::dense(dense_matrix<float>& m) {
+    Element* e;
+    float* r;
+    for (long i = 0; i < size_x; i++) {
+        e = liste[i];
+        if (e->size() != size_y)
+            throw new Error("Error: matrix rows should all have the same size");
+        if (e->type == t_floats) {
+            memcpy(m.row(i), ((Floats*)e)->liste.items->buffer + ((Floats*)e)->liste.home, sizeof(float)*size_y);
+            continue;
+        }
+        r = m.row(i);
+        for (long j = 0; j < size_y; j++)
+            r[j] = e->index(j)->asFloat();
+    }
+}
+
 void Matrice_float::build(LispE* lisp, Element* lst) {
     Floats* l;
     long idx = 0;
@@ -280,6 +348,169 @@ void Matrice_float::build(LispE* lisp, Element* lst) {
     }
 }
 
+//------------------------------------------------------------------------------------------
+//Matrix multiplication for (. m1 '+ '* m2)
+//c = a.b, where a is n x p, b is p x m and c is n x m, all contiguous
+//The computation is done by blocks of k and j, the inner loop being on contiguous rows
+//Each cell of c is summed in the same order as the generic inner product
+const long gemm_block = 128;
+//Below this number of multiplications, we do not launch threads
+const long gemm_threading = 1 << 21;
+
+static inline void gemm_row(double* c, double* b, double a, long jb, long jmax) {
+    long j = jb;
+#ifdef INTELINTRINSICS
+    __m256d va = {a, a, a, a};
+    for (; j + 4 <= jmax; j += 4)
+        _mm256_storeu_pd(c + j, _mm256_add_pd(_mm256_loadu_pd(c + j), _mm256_mul_pd(va, _mm256_loadu_pd(b + j))));
+#endif
+    for (; j < jmax; j++)
+        c[j] += a * b[j];
+}
+
+static inline void gemm_row(float* c, float* b, float a, long jb, long jmax) {
+    long j = jb;
+#ifdef INTELINTRINSICS
+    __m256 va = {a, a, a, a, a, a, a, a};
+    for (; j + 8 <= jmax; j += 8)
+        _mm256_storeu_ps(c + j, _mm256_add_ps(_mm256_loadu_ps(c + j), _mm256_mul_ps(va, _mm256_loadu_ps(b + j))));
+#endif
+    for (; j < jmax; j++)
+        c[j] += a * b[j];
+}
+
+//Rows [ifirst, ilast[ of c
+template <class Z> void gemm_rows(dense_matrix<Z>* a, dense_matrix<Z>* b, dense_matrix<Z>* c, long ifirst, long ilast) {
+    long p = a->size_y;
+    long m = b->size_y;
+    long i, k, kb, jb, kmax, jmax;
+    Z* arow;
+    Z* crow;
+    
+    for (jb = 0; jb < m; jb += gemm_block) {
+        jmax = lmin(jb + gemm_block, m);
+        for (kb = 0; kb < p; kb += gemm_block) {
+            kmax = lmin(kb + gemm_block, p);
+            for (i = ifirst; i < ilast; i++) {
+                arow = a->row(i);
+                crow = c->row(i);
+                for (k = kb; k < kmax; k++)
+                    gemm_row(crow, b->row(k), arow[k], jb, jmax);
+            }
+        }
+    }
+}
+
+template <class Z> void gemm(dense_matrix<Z>& a, dense_matrix<Z>& b, dense_matrix<Z>& c) {
+    long n = a.size_x;
+    long nbthreads = std::thread::hardware_concurrency();
+    
+    if (nbthreads <= 1 || n < 2*nbthreads || n * a.size_y * b.size_y < gemm_threading) {
+        gemm_rows(&a, &b, &c, 0, n);
+        return;
+    }
+    
+    //Each thread works on its own slice of rows in c
+    vecte<std::thread*> threads;
+    long slice = (n + nbthreads - 1) / nbthreads;
+    for (long i = 0; i < n; i += slice)
+        threads.push_back(new std::thread(gemm_rows<Z>, &a, &b, &c, i, lmin(i + slice, n)));
+    
+    for (long i = 0; i < threads.size(); i++) {
+        threads[i]->join();
+        delete threads[i];
+    }
+}
+
+//Each row of a Matrice (resp. Matrice_float) should be a Numbers (resp. Floats) of size_y elements
+//A row can be replaced with another list through set@
+bool dense_rows(Element* m) {
+    long sx, sy;
+    short row_type;
+    if (m->type == t_matrix) {
+        sx = ((Matrice*)m)->size_x;
+        sy = ((Matrice*)m)->size_y;
+        row_type = t_numbers;
+    }
+    else {
+        if (m->type != t_matrix_float)
+            return false;
+        sx = ((Matrice_float*)m)->size_x;
+        sy = ((Matrice_float*)m)->size_y;
+        row_type = t_floats;
+    }
+    
+    if (m->size() != sx)
+        return false;
+    
+    Element* row;
+    for (long i = 0; i < sx; i++) {
+        row = m->index(i);
+        if (row->type != row_type || row->size() != sy)
+            return false;
+    }
+    return true;
+}
+
+//m is either a Matrice or a Matrice_float, whose rows might have been replaced through set@
+static void dense_double(Element* m, dense_matrix<double>& d) {
+    if (m->type == t_matrix) {
+        ((Matrice*)m)->dense(d);
+        return;
+    }
+    
+    Element* row;
+    long j;
+    for (long i = 0; i < d.size_x; i++) {
+        row = m->index(i);
+        if (row->size() != d.size_y)
+            throw new Error("Error: matrix rows should all have the same size");
+        if (row->type == t_floats) {
+            for (j = 0; j < d.size_y; j++)
+                d(i,j) = ((Floats*)row)->liste[j];
+        }
+        else {
+            for (j = 0; j < d.size_y; j++)
+                d(i,j) = row->index(j)->asNumber();
+        }
+    }
+}
+
+//m1 and m2 are either Matrice or Matrice_float, with m1->size_y == m2->size_x
+//and their rows have been checked with dense_rows
+//The result is always a Matrice
+Element* matrix_product(LispE* lisp, Element* m1, Element* m2) {
+    long n, p, m;
+    m1->isPureList(n, p);
+    m2->isPureList(p, m);
+
+    if (m1->type == t_matrix_float && m2->type == t_matrix_float) {
+        dense_matrix<float> a(n, p);
+        dense_matrix<float> b(p, m);
+        dense_matrix<float> c(n, m);
+        ((Matrice_float*)m1)->dense(a);
+        ((Matrice_float*)m2)->dense(b);
+        gemm(a, b, c);
+        
+        Matrice* res = new Matrice(lisp, n, m, 0.0);
+        Numbers* row;
+        for (long i = 0; i < n; i++) {
+            row = (Numbers*)res->liste[i];
+            for (long j = 0; j < m; j++)
+                row->liste[j] = c(i,j);
+        }
+        return res;
+    }
+    
+    dense_matrix<double> a(n, p);
+    dense_matrix<double> b(p, m);
+    dense_matrix<double> c(n, m);
+    dense_double(m1, a);
+    dense_double(m2, b);
+    gemm(a, b, c);
+    return new Matrice(lisp, c);
+}
+
 void Tenseur::build(LispE* lisp, long isz, Element* res, double n) {
     if (isz == shape.size()-2) {
         Numbers* lst;
@@ -496,6 +727,249 @@ void List::combine(LispE* lisp, Element* l1, Element* l2, List* action) {
 }
 //------------------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------------------
+//Dense factorizations, used by determinant, invert, solve, cholesky and qr
+//They work in place on a dense_matrix, row by row, the inner loops being on contiguous rows
+//(see gemm_row above for the vectorized version of: c[j] += a * b[j])
+
+//LU decomposition with partial pivoting: P.a = L.U
+//L (unit diagonal) and U are stored in a, pivots records the row swaps
+//sign is the parity of the permutation
+//Returns false if the matrix is singular, with respect to the precision of Z
+template <class Z> bool dense_lu(dense_matrix<Z>& a, vecte<long>& pivots, long& sign) {
+    long n = a.size_x;
+    long i, k, p;
+    Z amax, v, pivot;
+    Z* rowk;
+    Z* rowi;
+    vecte<Z> swap(n);
+    
+    //A pivot is considered as a 0 when it is negligible with respect to the largest
+    //value of its own row in the original matrix: badly scaled rows are not singular
+    vecte<Z> scales(n);
+    Z epsilon = n * std::numeric_limits<Z>::epsilon();
+    for (i = 0; i < n; i++) {
+        amax = 0;
+        for (k = 0; k < n; k++) {
+            v = ABS(a(i, k));
+            if (v > amax)
+                amax = v;
+        }
+        scales.push_back(amax);
+    }
+    
+    sign = 1;
+    for (k = 0; k < n; k++) {
+        p = k;
+        amax = ABS(a(k, k));
+        for (i = k + 1; i < n; i++) {
+            v = ABS(a(i, k));
+            if (v > amax) {
+                amax = v;
+                p = i;
+            }
+        }
+        pivots.push_back(p);
+        if (amax <= epsilon * scales[p])
+            return false;
+        
+        rowk = a.row(k);
+        if (p != k) {
+            rowi = a.row(p);
+            memcpy(swap.vecteur, rowk, sizeof(Z)*n);
+            memcpy(rowk, rowi, sizeof(Z)*n);
+            memcpy(rowi, swap.vecteur, sizeof(Z)*n);
+            v = scales[k];
+            scales.vecteur[k] = scales[p];
+            scales.vecteur[p] = v;
+            sign = -sign;
+        }
+        
+        pivot = rowk[k];
+        for (i = k + 1; i < n; i++) {
+            rowi = a.row(i);
+            if (rowi[k] == 0)
+                continue;
+            rowi[k] /= pivot;
+            gemm_row(rowi, rowk, -rowi[k], k + 1, n);
+        }
+    }
+    return true;
+}
+
+//We solve a.x = b, with a and pivots coming from dense_lu
+//b is a n x m matrix, it is replaced with x
+template <class Z> void dense_lu_solve(dense_matrix<Z>& a, vecte<long>& pivots, dense_matrix<Z>& b) {
+    long n = a.size_x;
+    long m = b.size_y;
+    long i, k;
+    Z* rowi;
+    vecte<Z> swap(m);
+    
+    for (i = 0; i < n; i++) {
+        k = pivots[i];
+        if (k != i) {
+            memcpy(swap.vecteur, b.row(i), sizeof(Z)*m);
+            memcpy(b.row(i), b.row(k), sizeof(Z)*m);
+            memcpy(b.row(k), swap.vecteur, sizeof(Z)*m);
+        }
+    }
+    
+    //Forward substitution with L
+    for (i = 1; i < n; i++) {
+        rowi = b.row(i);
+        for (k = 0; k < i; k++) {
+            if (a(i, k) != 0)
+                gemm_row(rowi, b.row(k), -a(i, k), 0, m);
+        }
+    }
+    
+    //Backward substitution with U
+    Z d;
+    for (i = n - 1; i >= 0; i--) {
+        rowi = b.row(i);
+        for (k = i + 1; k < n; k++) {
+            if (a(i, k) != 0)
+                gemm_row(rowi, b.row(k), -a(i, k), 0, m);
+        }
+        d = 1 / a(i, i);
+        for (k = 0; k < m; k++)
+            rowi[k] *= d;
+    }
+}
+
+//Cholesky decomposition of a symmetric positive definite matrix: a = L.tL
+//L is stored in the lower part of a, the upper part is set to 0
+//Returns false if a is not positive definite
+template <class Z> bool dense_cholesky(dense_matrix<Z>& a) {
+    long n = a.size_x;
+    long i, j, k;
+    Z v;
+    Z* rowi;
+    Z* rowj;
+    
+    for (i = 0; i < n; i++) {
+        rowi = a.row(i);
+        for (j = 0; j <= i; j++) {
+            rowj = a.row(j);
+            v = rowi[j];
+            for (k = 0; k < j; k++)
+                v -= rowi[k] * rowj[k];
+            if (i == j) {
+                if (v <= 0)
+                    return false;
+                rowi[i] = sqrt(v);
+            }
+            else
+                rowi[j] = v / rowj[j];
+        }
+        for (j = i + 1; j < n; j++)
+            rowi[j] = 0;
+    }
+    return true;
+}
+
+//We solve L.tL.x = b, b is replaced with x
+template <class Z> void dense_cholesky_solve(dense_matrix<Z>& l, dense_matrix<Z>& b) {
+    long n = l.size_x;
+    long m = b.size_y;
+    long i, k;
+    Z d;
+    Z* rowi;
+    
+    for (i = 0; i < n; i++) {
+        rowi = b.row(i);
+        for (k = 0; k < i; k++)
+            gemm_row(rowi, b.row(k), -l(i, k), 0, m);
+        d = 1 / l(i, i);
+        for (k = 0; k < m; k++)
+            rowi[k] *= d;
+    }
+    
+    for (i = n - 1; i >= 0; i--) {
+        rowi = b.row(i);
+        for (k = i + 1; k < n; k++)
+            gemm_row(rowi, b.row(k), -l(k, i), 0, m);
+        d = 1 / l(i, i);
+        for (k = 0; k < m; k++)
+            rowi[k] *= d;
+    }
+}
+
+//Householder QR decomposition of a r x c matrix (r >= c)
+//On return, the upper part of a contains R, the Householder vectors are stored in v (one per column)
+//Returns false if the matrix is rank deficient
+template <class Z> bool dense_qr(dense_matrix<Z>& a, dense_matrix<Z>& v) {
+    long r = a.size_x;
+    long c = a.size_y;
+    long i, j, k;
+    Z norm, s, alpha;
+    
+    //A column is considered as dependent when what remains of it is negligible
+    //with respect to its original norm: badly scaled columns are not rank deficient
+    vecte<Z> scales(c);
+    Z epsilon = r * std::numeric_limits<Z>::epsilon();
+    for (k = 0; k < c; k++) {
+        norm = 0;
+        for (i = 0; i < r; i++)
+            norm += a(i, k) * a(i, k);
+        scales.push_back(sqrt(norm));
+    }
+    
+    for (k = 0; k < c; k++) {
+        norm = 0;
+        for (i = k; i < r; i++)
+            norm += a(i, k) * a(i, k);
+        norm = sqrt(norm);
+        if (norm <= epsilon * scales[k])
+            return false;
+        
+        alpha = (a(k, k) > 0)?-norm:norm;
+        for (i = 0; i < r; i++)
+            v(k, i) = (i < k)?0:a(i, k);
+        v(k, k) -= alpha;
+        
+        s = 0;
+        for (i = k; i < r; i++)
+            s += v(k, i) * v(k, i);
+        s = sqrt(s);
+        if (s == 0)
+            continue;
+        for (i = k; i < r; i++)
+            v(k, i) /= s;
+        
+        //a = a - 2v(tv.a)
+        for (j = k; j < c; j++) {
+            s = 0;
+            for (i = k; i < r; i++)
+                s += v(k, i) * a(i, j);
+            s *= 2;
+            for (i = k; i < r; i++)
+                a(i, j) -= s * v(k, i);
+        }
+    }
+    return true;
+}
+
+//We apply the reflections stored in v to b (r x m): b = tQ.b
+template <class Z> void dense_qr_apply(dense_matrix<Z>& v, dense_matrix<Z>& b, long c) {
+    long r = b.size_x;
+    long m = b.size_y;
+    long i, j, k;
+    Z s;
+    
+    for (k = 0; k < c; k++) {
+        for (j = 0; j < m; j++) {
+            s = 0;
+            for (i = k; i < r; i++)
+                s += v(k, i) * b(i, j);
+            s *= 2;
+            for (i = k; i < r; i++)
+                b(i, j) -= s * v(k, i);
+        }
+    }
+}
+
 //LU decomposition
 long LUDCMP(long n, vecte<long>& indexes, long& d, Matrice* m) {
     d = 1;
@@ -600,40 +1074,36 @@ void LUBKSB(long n, vecte<long>& indexes, vecte<double>& b_values, Matrice* m)
 } // LUBKSB
 
 double Matrice::determinant() {
-    if (size_x == 2 && size_y == 2) {
-        //then in that case
-        return (val(0,0) * val(1,1) - val(1,0) * val(0,1));
-    }
-
     if (size_x != size_y)
         throw new Error("Error: we can only apply 'determinant' to square matrices");
-    
-    long i;
-    i = 0;
-    double det = 0;
-    for (long j = 0; j < size_x; j++) {
-        if (val(i,j) == 0)
-            continue;
 
-        Matrice sub(size_x - 1, size_y - 1, 0.0);
+    //The rows are first checked and copied into a dense buffer
+    dense_matrix<double> m(size_x, size_y);
+    dense(m);
 
-        long pc = 0;
-        long pr = 0;
-        for (long r = 0; r < size_x; r++) {
-            if (r == i)
-                continue;
-            pc = 0;
-            for (long c = 0; c < size_y; c++) {
-                if (c == j)
-                    continue;
-                sub.set(pr,pc, val(r,c));
-                pc++;
-            }
-            pr++;
-        }
-        double sg = pow(-1, (i + j + 2));
-        det += val(i,j) * sg*sub.determinant();
+    if (size_x == 1)
+        return m(0,0);
+    
+    if (size_x == 2) {
+        //then in that case
+        return (m(0,0) * m(1,1) - m(1,0) * m(0,1));
+    }
+
+    if (size_x == 3) {
+        return m(0,0) * (m(1,1) * m(2,2) - m(1,2) * m(2,1))
+        - m(0,1) * (m(1,0) * m(2,2) - m(1,2) * m(2,0))
+        + m(0,2) * (m(1,0) * m(2,1) - m(1,1) * m(2,0));
     }
+    
+    //The determinant is the product of the diagonal of U in the LU decomposition
+    vecte<long> pivots(size_x);
+    long sign;
+    if (!dense_lu(m, pivots, sign))
+        return 0;
+    
+    double det = sign;
+    for (long i = 0; i < size_x; i++)
+        det *= m(i, i);
     return det;
 }
 
@@ -642,68 +1112,139 @@ Element* Matrice::inversion(LispE* lisp) {
         throw new Error("Error: we can only apply 'invert' to square matrices");
 
     //else Local decomposition
-    Matrice m(this);
-    
-    
-    vecte<long> indexes(size_x);
-    long id;
-    //call LU decomposition
-    long rc = LUDCMP(size_x, indexes, id, &m);
-    if (rc == 1) {
+    dense_matrix<double> m(size_x, size_y);
+    dense(m);
+    vecte<long> pivots(size_x);
+    long sign;
+    if (!dense_lu(m, pivots, sign))
         return emptylist_;
-    }
     
-    Matrice* Y = new Matrice(lisp, size_x, size_x, 0.0);
-    
-    long i;
-    //We create an identity matrix, which will contain the final result...
-    for (i = 0; i < size_x; i++) {
-        Y->set(i,i, 1);
-    }
-    
-    vecte<double> temp(size_x);
-
-    for (long j = 0; j < size_x; j++) {
-        for (i = 0; i < size_x; i++) {
-            temp.at(i, Y->val(i, j));
-        }
-        LUBKSB(size_x, indexes, temp, &m);
-        for (i = 0; i < size_x; i++) {
-            Y->set(i,j,temp[i]);
-        }
-    }
-    return Y;
+    //We solve m.Y = I
+    dense_matrix<double> Y(size_x, size_x);
+    for (long i = 0; i < size_x; i++)
+        Y(i, i) = 1;
+    dense_lu_solve(m, pivots, Y);
+    return new Matrice(lisp, Y);
 }
 
 Element* Matrice::solve(LispE* lisp, Matrice* y) {
-    if (size_x != size_y || y->size_x != y->size_y || size_x != y->size_x)
-        throw new Error("Error: we can only apply 'solve' to square matrices of equal sizes");
+    if (size_x != size_y || size_x != y->size_x)
+        throw new Error("Error: we can only apply 'solve' to a square matrix and a matrix with the same number of rows");
 
     //else Local decomposition
-    Matrice m(this);
-        
-    vecte<long> indexes(size_x);
-    long id;
-    //call LU decomposition
-    long rc = LUDCMP(size_x, indexes, id, &m);
-    if (rc == 1) {
+    dense_matrix<double> m(size_x, size_y);
+    dense(m);
+    vecte<long> pivots(size_x);
+    long sign;
+    if (!dense_lu(m, pivots, sign))
         return emptylist_;
-    }
         
-    Matrice* Y = new Matrice(lisp, y);
-    vecte<double> temp(size_x);
-    long i;
+    dense_matrix<double> Y(y->size_x, y->size_y);
+    y->dense(Y);
+    dense_lu_solve(m, pivots, Y);
+    return new Matrice(lisp, Y);
+}
 
-    for (long j = 0; j < size_x; j++) {
-        for (i = 0; i < size_x; i++) {
-            temp.at(i, Y->val(i, j));
+//Cholesky decomposition for symmetric positive definite matrices
+//Without Y, we return L, such as this = L.tL
+//With Y, we solve this.X = Y
+Element* Matrice::cholesky(LispE* lisp, Matrice* y) {
+    if (size_x != size_y)
+        throw new Error("Error: we can only apply 'cholesky' to square matrices");
+    
+    if (y != NULL && y->size_x != size_x)
+        throw new Error("Error: the matrices should have the same number of rows");
+    
+    //The symmetry is checked on the dense copy, since rows might have been replaced
+    //Values are compared up to a relative rounding error
+    dense_matrix<double> m(size_x, size_y);
+    dense(m);
+    double epsilon = size_x * std::numeric_limits<double>::epsilon();
+    long i, j;
+    for (i = 0; i < size_x; i++) {
+        for (j = 0; j < i; j++) {
+            if (fabs(m(i, j) - m(j, i)) > epsilon * std::max(fabs(m(i, j)), fabs(m(j, i))))
+                throw new Error("Error: we can only apply 'cholesky' to symmetric matrices");
         }
-        LUBKSB(size_x, indexes, temp, &m);
-        for (i = 0; i < size_x; i++) {
-            Y->set(i,j,temp[i]);
+    }
+
+    if (!dense_cholesky(m))
+        return emptylist_;
+    
+    if (y == NULL)
+        return new Matrice(lisp, m);
+    
+    dense_matrix<double> Y(y->size_x, y->size_y);
+    y->dense(Y);
+    dense_cholesky_solve(m, Y);
+    return new Matrice(lisp, Y);
+}
+
+//QR decomposition for matrices with at least as many rows as columns
+//Without Y, we return (Q R), with Q: size_x x size_y and R: size_y x size_y
+//With Y, we return X, the least-squares solution of this.X = Y
+Element* Matrice::qr(LispE* lisp, Matrice* y) {
+    if (size_x < size_y)
+        throw new Error("Error: we can only apply 'qr' to matrices with at least as many rows as columns");
+
+    if (y != NULL && y->size_x != size_x)
+        throw new Error("Error: the matrices should have the same number of rows");
+
+    long r = size_x;
+    long c = size_y;
+    long i, j, k;
+    double s;
+    
+    dense_matrix<double> m(r, c);
+    dense(m);
+    dense_matrix<double> v(c, r);
+    if (!dense_qr(m, v))
+        return emptylist_;
+
+    if (y == NULL) {
+        //Q is the product of the reflections applied to the first columns of the identity
+        dense_matrix<double> Q(r, c);
+        for (i = 0; i < c; i++)
+            Q(i, i) = 1;
+        for (k = c - 1; k >= 0; k--) {
+            for (j = 0; j < c; j++) {
+                s = 0;
+                for (i = k; i < r; i++)
+                    s += v(k, i) * Q(i, j);
+                s *= 2;
+                for (i = k; i < r; i++)
+                    Q(i, j) -= s * v(k, i);
+            }
+        }
+        
+        m.restrict(0, 0, c, c);
+        for (i = 1; i < c; i++) {
+            for (j = 0; j < i; j++)
+                m(i, j) = 0;
         }
+        
+        List* res = lisp->provideList();
+        res->append(new Matrice(lisp, Q));
+        res->append(new Matrice(lisp, m));
+        return res;
     }
-    return Y;
+    
+    //X = R-1.tQ.Y
+    dense_matrix<double> Y(y->size_x, y->size_y);
+    y->dense(Y);
+    dense_qr_apply(v, Y, c);
+    Y.restrict(0, 0, c, Y.size_y);
+    
+    double* rowi;
+    for (i = c - 1; i >= 0; i--) {
+        rowi = Y.row(i);
+        for (k = i + 1; k < c; k++)
+            gemm_row(rowi, Y.row(k), -m(i, k), 0, Y.size_y);
+        s = 1 / m(i, i);
+        for (k = 0; k < Y.size_y; k++)
+            rowi[k] *= s;
+    }
+    return new Matrice(lisp, Y);
 }
 
 Element* Matrice::ludcmp(LispE* lisp) {
@@ -862,40 +1403,36 @@ void LUBKSB(long n, vecte<long>& indexes, vecte<float>& b_values, Matrice_float*
 } // LUBKSB
 
 float Matrice_float::determinant() {
-    if (size_x == 2 && size_y == 2) {
-        //then in that case
-        return (val(0,0) * val(1,1) - val(1,0) * val(0,1));
-    }
-
     if (size_x != size_y)
         throw new Error("Error: we can only apply 'determinant' to square matrices");
-    
-    long i;
-    i = 0;
-    float det = 0;
-    for (long j = 0; j < size_x; j++) {
-        if (val(i,j) == 0)
-            continue;
 
-        Matrice_float sub(size_x - 1, size_y - 1, 0.0);
+    //The rows are first checked and copied into a dense buffer
+    dense_matrix<float> m(size_x, size_y);
+    dense(m);
 
-        long pc = 0;
-        long pr = 0;
-        for (long r = 0; r < size_x; r++) {
-            if (r == i)
-                continue;
-            pc = 0;
-            for (long c = 0; c < size_y; c++) {
-                if (c == j)
-                    continue;
-                sub.set(pr,pc, val(r,c));
-                pc++;
-            }
-            pr++;
-        }
-        float sg = pow(-1, (i + j + 2));
-        det += val(i,j) * sg*sub.determinant();
+    if (size_x == 1)
+        return m(0,0);
+    
+    if (size_x == 2) {
+        //then in that case
+        return (m(0,0) * m(1,1) - m(1,0) * m(0,1));
+    }
+
+    if (size_x == 3) {
+        return m(0,0) * (m(1,1) * m(2,2) - m(1,2) * m(2,1))
+        - m(0,1) * (m(1,0) * m(2,2) - m(1,2) * m(2,0))
+        + m(0,2) * (m(1,0) * m(2,1) - m(1,1) * m(2,0));
     }
+    
+    //The determinant is the product of the diagonal of U in the LU decomposition
+    vecte<long> pivots(size_x);
+    long sign;
+    if (!dense_lu(m, pivots, sign))
+        return 0;
+    
+    float det = sign;
+    for (long i = 0; i < size_x; i++)
+        det *= m(i, i);
     return det;
 }
 
@@ -904,68 +1441,37 @@ Element* Matrice_float::inversion(LispE* lisp) {
         throw new Error("Error: we can only apply 'invert' to square matrices");
 
     //else Local decomposition
-    Matrice_float m(this);
-    
-    
-    vecte<long> indexes(size_x);
-    long id;
-    //call LU decomposition
-    long rc = LUDCMP(size_x, indexes, id, &m);
-    if (rc == 1) {
+    dense_matrix<float> m(size_x, size_y);
+    dense(m);
+    vecte<long> pivots(size_x);
+    long sign;
+    if (!dense_lu(m, pivots, sign))
         return emptylist_;
-    }
-    
-    Matrice_float* Y = new Matrice_float(lisp, size_x, size_x, 0.0);
-    
-    long i;
-    //We create an identity matrix, which will contain the final result...
-    for (i = 0; i < size_x; i++) {
-        Y->set(i,i, 1);
-    }
     
-    vecte<float> temp(size_x);
-
-    for (long j = 0; j < size_x; j++) {
-        for (i = 0; i < size_x; i++) {
-            temp.at(i, Y->val(i, j));
-        }
-        LUBKSB(size_x, indexes, temp, &m);
-        for (i = 0; i < size_x; i++) {
-            Y->set(i,j,temp[i]);
-        }
-    }
-    return Y;
+    //We solve m.Y = I
+    dense_matrix<float> Y(size_x, size_x);
+    for (long i = 0; i < size_x; i++)
+        Y(i, i) = 1;
+    dense_lu_solve(m, pivots, Y);
+    return new Matrice_float(lisp, Y);
 }
 
 Element* Matrice_float::solve(LispE* lisp, Matrice_float* y) {
-    if (size_x != size_y || y->size_x != y->size_y || size_x != y->size_x)
-        throw new Error("Error: we can only apply 'solve' to square matrices of equal sizes");
+    if (size_x != size_y || size_x != y->size_x)
+        throw new Error("Error: we can only apply 'solve' to a square matrix and a matrix with the same number of rows");
 
     //else Local decomposition
-    Matrice_float m(this);
-        
-    vecte<long> indexes(size_x);
-    long id;
-    //call LU decomposition
-    long rc = LUDCMP(size_x, indexes, id, &m);
-    if (rc == 1) {
+    dense_matrix<float> m(size_x, size_y);
+    dense(m);
+    vecte<long> pivots(size_x);
+    long sign;
+    if (!dense_lu(m, pivots, sign))
         return emptylist_;
-    }
         
-    Matrice_float* Y = new Matrice_float(lisp, y);
-    vecte<float> temp(size_x);
-    long i;
-
-    for (long j = 0; j < size_x; j++) {
-        for (i = 0; i < size_x; i++) {
-            temp.at(i, Y->val(i, j));
-        }
-        LUBKSB(size_x, indexes, temp, &m);
-        for (i = 0; i < size_x; i++) {
-            Y->set(i,j,temp[i]);
-        }
-    }
-    return Y;
+    dense_matrix<float> Y(y->size_x, y->size_y);
+    y->dense(Y);
+    dense_lu_solve(m, pivots, Y);
+    return new Matrice_float(lisp, Y);
 }
 
 Element* Matrice_float::ludcmp(LispE* lisp) {
@@ -2504,7 +3010,7 @@ Element* List::rightshift(LispE* lisp, Element* e) {
 
 Element* Floats::bit_not(LispE* l) {
     //Two cases either e is a number or it is a list...
-    if (!status) {
+    if (!liste.shared(status)) {
         for (long i = 0; i < size(); i++) {
             replacing(i, index(i)->bit_not(l));
         }
@@ -3395,7 +3901,7 @@ Element* Floats::rightshift(LispE* lisp, Element* e) {
 
 Element* Numbers::bit_not(LispE* l) {
     //Two cases either e is a number or it is a list...
-    if (!status) {
+    if (!liste.shared(status)) {
         for (long i = 0; i < size(); i++) {
             replacing(i, index(i)->bit_not(l));
         }
@@ -4295,7 +4801,7 @@ Element* Numbers::rightshift(LispE* lisp, Element* e) {
 }
 
 Element* Integers::bit_not(LispE* l) {
-    if (!status) {
+    if (!liste.shared(status)) {
         for (long i = 0; i < size(); i++) {
             liste[i] = ~liste[i];
         }
@@ -4334,14 +4840,16 @@ Element* Integers::bit_and(LispE* lisp, Element* e) {
             release();
             return result;
         }
-        for (long i = 0; i < e->size() && i < size(); i++) {
+        if (e->type == t_integers) {
+            liste.bit_and(((Integers*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
+        for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] &= e->index(i)->asInteger();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] &= e->asInteger();
-    }
+    liste.bit_and(e->asInteger());
     return this;
 }
 
@@ -4370,14 +4878,16 @@ Element* Integers::bit_and_not(LispE* lisp, Element* e) {
             release();
             return result;
         }
+        if (e->type == t_integers) {
+            liste.bit_and_not(((Integers*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
         for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] &= ~e->index(i)->asInteger();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] &= ~e->asInteger();
-    }
+    liste.bit_and_not(e->asInteger());
     return this;
 }
 
@@ -4406,14 +4916,16 @@ Element* Integers::bit_or(LispE* lisp, Element* e) {
             release();
             return result;
         }
+        if (e->type == t_integers) {
+            liste.bit_or(((Integers*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
         for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] |= e->index(i)->asInteger();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] |= e->asInteger();
-    }
+    liste.bit_or(e->asInteger());
     return this;
 }
 
@@ -4441,14 +4953,16 @@ Element* Integers::bit_xor(LispE* lisp, Element* e) {
             release();
             return result;
         }
+        if (e->type == t_integers) {
+            liste.bit_xor(((Integers*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
         for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] ^= e->index(i)->asInteger();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] ^= e->asInteger();
-    }
+    liste.bit_xor(e->asInteger());
     return this;
 }
 
@@ -5021,14 +5535,16 @@ Element* Integers::leftshift(LispE* lisp, Element* e) {
             release();
             return result;
         }
-       for (long i = 0; i < e->size() && i < size(); i++) {
+        if (e->type == t_integers) {
+            liste.leftshift(((Integers*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
+        for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] <<= e->index(i)->asInteger();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] <<= e->asInteger();
-    }
+    liste.leftshift(e->asInteger());
     return this;
 }
 
@@ -5056,19 +5572,21 @@ Element* Integers::rightshift(LispE* lisp, Element* e) {
             release();
             return result;
         }
+        if (e->type == t_integers) {
+            liste.rightshift(((Integers*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
         for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] >>= e->index(i)->asInteger();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] >>= e->asInteger();
-    }
+    liste.rightshift(e->asInteger());
     return this;
 }
 
 Element* Shorts::bit_not(LispE* l) {
-    if (!status) {
+    if (!liste.shared(status)) {
         for (long i = 0; i < size(); i++) {
             liste[i] = ~liste[i];
         }
@@ -5107,14 +5625,16 @@ Element* Shorts::bit_and(LispE* lisp, Element* e) {
             release();
             return result;
         }
+        if (e->type == t_shorts) {
+            liste.bit_and(((Shorts*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
         for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] &= e->index(i)->asShort();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] &= e->asShort();
-    }
+    liste.bit_and(e->asShort());
     return this;
 }
 
@@ -5143,14 +5663,16 @@ Element* Shorts::bit_and_not(LispE* lisp, Element* e) {
             release();
             return result;
         }
+        if (e->type == t_shorts) {
+            liste.bit_and_not(((Shorts*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
         for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] &= ~e->index(i)->asShort();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] &= ~e->asShort();
-    }
+    liste.bit_and_not(e->asShort());
     return this;
 }
 
@@ -5179,14 +5701,16 @@ Element* Shorts::bit_or(LispE* lisp, Element* e) {
             release();
             return result;
         }
+        if (e->type == t_shorts) {
+            liste.bit_or(((Shorts*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
         for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] |= e->index(i)->asShort();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] |= e->asShort();
-    }
+    liste.bit_or(e->asShort());
     return this;
 }
 
@@ -5214,14 +5738,16 @@ Element* Shorts::bit_xor(LispE* lisp, Element* e) {
             release();
             return result;
         }
+        if (e->type == t_shorts) {
+            liste.bit_xor(((Shorts*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
         for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] ^= e->index(i)->asShort();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] ^= e->asShort();
-    }
+    liste.bit_xor(e->asShort());
     return this;
 }
 
@@ -5714,14 +6240,16 @@ Element* Shorts::leftshift(LispE* lisp, Element* e) {
             release();
             return result;
         }
-       for (long i = 0; i < e->size() && i < size(); i++) {
+        if (e->type == t_shorts) {
+            liste.leftshift(((Shorts*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
+        for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] <<= e->index(i)->asShort();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] <<= e->asShort();
-    }
+    liste.leftshift(e->asShort());
     return this;
 }
 
@@ -5749,14 +6277,16 @@ Element* Shorts::rightshift(LispE* lisp, Element* e) {
             release();
             return result;
         }
+        if (e->type == t_shorts) {
+            liste.rightshift(((Shorts*)e)->liste, lmin(size(), e->size()));
+            return this;
+        }
         for (long i = 0; i < e->size() && i < size(); i++) {
             liste[i] >>= e->index(i)->asShort();
         }
         return this;
     }
-    for (long i = 0; i < size(); i++) {
-        liste[i] >>= e->asShort();
-    }
+    liste.rightshift(e->asShort());
     return this;
 }
 
@@ -8408,6 +8938,278 @@ Element* List_plusn::eval(LispE* lisp) {
     return first_element;
 }
 
+//------------------------------------------------------------------------------------------
+//Fused arithmetic expressions
+//------------------------------------------------------------------------------------------
+//Number of values computed at once in a fused expression
+const long fused_chunk = 256;
+
+//An operation is a call to +, -, * or / with at least two arguments
+bool List_fused_arithmetic::operation(Element* e) {
+    if (e->type != t_list || e->size() < 3)
+        return false;
+    short op = e->index(0)->type;
+    return (op == l_plus || op == l_minus || op == l_multiply || op == l_divide);
+}
+
+//An expression can be fused if it contains at least one operation among its arguments
+//and if all its leaves are variables or numbers, which can be evaluated in advance without side effects
+static bool fused_leaves(Element* e) {
+    for (long i = 1; i < e->size(); i++) {
+        Element* a = e->index(i);
+        if (List_fused_arithmetic::operation(a)) {
+            if (!fused_leaves(a))
+                return false;
+        }
+        else {
+            if (a->type != t_atom && (a->type < t_float || a->type > t_number))
+                return false;
+        }
+    }
+    return true;
+}
+
+bool List_fused_arithmetic::fusable(Element* e) {
+    for (long i = 1; i < e->size(); i++) {
+        if (operation(e->index(i)))
+            return fused_leaves(e);
+    }
+    return false;
+}
+
+void List_fused_arithmetic::counting_leaves(Element* e) {
+    for (long i = 1; i < e->size(); i++) {
+        if (operation(e->index(i)))
+            counting_leaves(e->index(i));
+        else
+            nb_leaves++;
+    }
+}
+
+//We evaluate the leaves in the same order as the regular evaluation would
+static void fused_values(LispE* lisp, Element* e, Element** values, long& pos) {
+    Element* a;
+    for (long i = 1; i < e->size(); i++) {
+        a = e->index(i);
+        if (List_fused_arithmetic::operation(a))
+            fused_values(lisp, a, values, pos);
+        else {
+            //pos is only incremented once the evaluation has succeeded
+            values[pos] = a->eval(lisp);
+            pos++;
+        }
+    }
+}
+
+//Returns 2 if the sub-expression is a numbers container, 1 if it is a single value, 0 otherwise
+//For a fused computation, the first argument of each operation must be a container
+//of the same size as all the others
+char List_fused_arithmetic::checking(Element* e, Element** values, long& pos, long& sz) {
+    char kind;
+    Element* a;
+    for (long i = 1; i < e->size(); i++) {
+        a = e->index(i);
+        if (operation(a))
+            kind = checking(a, values, pos, sz);
+        else {
+            a = values[pos++];
+            switch (a->type) {
+                case t_numbers:
+                    if (sz == -1)
+                        sz = a->size();
+                    kind = (sz == a->size())?2:0;
+                    break;
+                case t_float:
+                case t_short:
+                case t_integer:
+                case t_number:
+                    kind = 1;
+                    break;
+                default:
+                    kind = 0;
+            }
+        }
+        if (!kind || (i == 1 && kind != 2))
+            return 0;
+    }
+    return 2;
+}
+
+//We compute the values between [first, first + nb[ for this operation
+void List_fused_arithmetic::computing(Element* e, Element** values, long& pos, long first, long nb, double* result) {
+    double local[fused_chunk];
+    double* v;
+    double d = 0;
+    long j;
+    short op = e->index(0)->type;
+    Element* a;
+    
+    for (long i = 1; i < e->size(); i++) {
+        a = e->index(i);
+        v = NULL;
+        if (operation(a)) {
+            v = (i == 1)?result:local;
+            computing(a, values, pos, first, nb, v);
+            if (i == 1)
+                continue;
+        }
+        else {
+            a = values[pos++];
+            if (a->type == t_numbers)
+                v = ((Numbers*)a)->liste.items->buffer + ((Numbers*)a)->liste.home + first;
+            else
+                d = a->asNumber();
+            
+            if (i == 1) {
+                memcpy(result, v, sizeof(double)*nb);
+                continue;
+            }
+        }
+        
+        if (v == NULL) {
+            switch (op) {
+                case l_plus:
+                    for (j = 0; j < nb; j++)
+                        result[j] += d;
+                    break;
+                case l_minus:
+                    for (j = 0; j < nb; j++)
+                        result[j] -= d;
+                    break;
+                case l_multiply:
+                    for (j = 0; j < nb; j++)
+                        result[j] *= d;
+                    break;
+                default:
+                    if (!d)
+                        throw new Error("Error: division by zero");
+                    for (j = 0; j < nb; j++)
+                        result[j] /= d;
+            }
+        }
+        else {
+            switch (op) {
+                case l_plus:
+                    for (j = 0; j < nb; j++)
+                        result[j] += v[j];
+                    break;
+                case l_minus:
+                    for (j = 0; j < nb; j++)
+                        result[j] -= v[j];
+                    break;
+                case l_multiply:
+                    for (j = 0; j < nb; j++)
+                        result[j] *= v[j];
+                    break;
+                default:
+                    for (j = 0; j < nb; j++) {
+                        if (!v[j])
+                            throw new Error("Error: division by zero");
+                        result[j] /= v[j];
+                    }
+            }
+        }
+    }
+}
+
+//The regular evaluation, same as List_plusn and its siblings, applied to the values of the leaves
+Element* List_fused_arithmetic::evaluating(LispE* lisp, Element* e, Element** values, long& pos) {
+    short op = e->index(0)->type;
+    Element* first_element = e->index(1);
+    if (operation(first_element))
+        first_element = evaluating(lisp, first_element, values, pos);
+    else
+        first_element = values[pos++];
+    first_element = first_element->copyatom(lisp, 1);
+    
+    Element* second_element = null_;
+    try {
+        for (long i = 2; i < e->size(); i++) {
+            second_element = e->index(i);
+            if (operation(second_element))
+                second_element = evaluating(lisp, second_element, values, pos);
+            else
+                second_element = values[pos++];
+            
+            switch (op) {
+                case l_plus:
+                    first_element = first_element->plus_direct(lisp, second_element);
+                    break;
+                case l_minus:
+                    first_element = first_element->minus_direct(lisp, second_element);
+                    break;
+                case l_multiply:
+                    first_element = first_element->multiply_direct(lisp, second_element);
+                    break;
+                default:
+                    first_element = first_element->divide_direct(lisp, second_element);
+            }
+            if (first_element != second_element)
+                _releasing(second_element);
+        }
+    }
+    catch (Error* err) {
+        if (first_element != second_element)
+            second_element->release();
+        first_element->release();
+        throw err;
+    }
+    return first_element;
+}
+
+Element* List_fused_arithmetic::eval(LispE* lisp) {
+    Element* buffer[16];
+    Element** values = (nb_leaves <= 16)?buffer:new Element*[nb_leaves];
+    long pos = 0;
+    long i;
+    
+    try {
+        fused_values(lisp, this, values, pos);
+    }
+    catch (Error* err) {
+        for (i = 0; i < pos; i++)
+            values[i]->release();
+        if (values != buffer)
+            delete[] values;
+        throw err;
+    }
+    
+    Element* result = null_;
+    long sz = -1;
+    pos = 0;
+    bool fused = checking(this, values, pos, sz);
+    
+    pos = 0;
+    try {
+        if (fused) {
+            Numbers* res = lisp->provideNumbers();
+            result = res;
+            double* r = res->liste.allocate(sz);
+            for (i = 0; i < sz; i += fused_chunk) {
+                pos = 0;
+                computing(this, values, pos, i, lmin(fused_chunk, sz - i), r + i);
+            }
+            for (i = 0; i < nb_leaves; i++)
+                values[i]->release();
+        }
+        else
+            result = evaluating(lisp, this, values, pos);
+    }
+    catch (Error* err) {
+        //In the fused case, no value has been consumed yet
+        for (i = fused?0:pos; i < nb_leaves; i++)
+            values[i]->release();
+        if (values != buffer)
+            delete[] values;
+        result->release();
+        throw err;
+    }
+    
+    if (values != buffer)
+        delete[] values;
+    return result;
+}
+
 Element* List_plus2::eval(LispE* lisp) {
     Element* first_element = liste[1]->eval(lisp);
     if (!first_element->isList())
@@ -10241,17 +11043,63 @@ Element* List::evall_powerequal2(LispE* lisp) {
 
 //------------------------------------------------------------------------------------------
 
+//Above this size, a sum is split across threads
+const long parallel_reduction = 1 << 20;
+
+template <class Z> void partial_sum(Z* v, long nb, Z* result) {
+    *result = item_a<Z>::pairwise_sum(v, nb);
+}
+
+template <class Z> Z parallel_sum(vecte_a<Z>& l) {
+    long nb = l.size();
+    Z* v = l.items->buffer + l.home;
+    long nbthreads = std::thread::hardware_concurrency();
+    if (nbthreads <= 1 || nb < parallel_reduction)
+        return item_a<Z>::pairwise_sum(v, nb);
+    
+    vecte<std::thread*> threads;
+    //ceiling division first, then rounded up to a multiple of 4: at most nbthreads slices
+    long slice = (((nb + nbthreads - 1) / nbthreads) + 3) & ~3;
+    Z* results = new Z[(nb + slice - 1) / slice];
+    long i, t = 0;
+    for (i = 0; i < nb; i += slice)
+        threads.push_back(new std::thread(partial_sum<Z>, v + i, lmin(slice, nb - i), results + t++));
+    
+    Z s = 0;
+    for (i = 0; i < threads.size(); i++) {
+        threads[i]->join();
+        delete threads[i];
+        s += results[i];
+    }
+    delete[] results;
+    return s;
+}
+
+//(sum lst true) uses a compensated summation on floats and numbers
 Element* List::evall_sum(LispE* lisp) {
     Element* first_element = liste[1]->eval(lisp);
+    bool compensated = false;
+    if (liste.size() == 3) {
+        Element* e = null_;
+        try {
+            e = liste[2]->eval(lisp);
+        }
+        catch (Error* err) {
+            first_element->release();
+            throw err;
+        }
+        compensated = e->Boolean();
+        e->release();
+    }
     
     switch (first_element->type) {
         case t_floats: {
-            float v = ((Floats*)first_element)->liste.sum();
+            float v = compensated?((Floats*)first_element)->liste.compensated_sum():parallel_sum(((Floats*)first_element)->liste);
             first_element->release();
             return v?lisp->provideFloat(v):zero_;
         }
         case t_numbers: {
-            double v = ((Numbers*)first_element)->liste.sum();
+            double v = compensated?((Numbers*)first_element)->liste.compensated_sum():parallel_sum(((Numbers*)first_element)->liste);
             first_element->release();
             return v?lisp->provideNumber(v):zero_;
         }
@@ -10261,7 +11109,7 @@ Element* List::evall_sum(LispE* lisp) {
             return v?new Short(v):zero_;
         }
         case t_integers: {
-            long v = ((Integers*)first_element)->liste.sum();
+            long v = parallel_sum(((Integers*)first_element)->liste);
             first_element->release();
             return v?lisp->provideInteger(v):zero_;
         }
@@ -10446,6 +11294,60 @@ Element* List::evall_determinant(LispE* lisp) {
     return lisp->provideNumber(det);
 }
 
+Element* List::evall_cholesky(LispE* lisp) {
+    Element* element = liste[1]->eval(lisp);
+    Element* Y = NULL;
+    Element* res;
+
+    try {
+        if (element->type != t_matrix)
+            throw new Error("Error: 'cholesky' can only be applied to matrices");
+        if (liste.size() == 3) {
+            Y = liste[2]->eval(lisp);
+            if (Y->type != t_matrix)
+                throw new Error("Error: 'cholesky' can only be applied to matrices");
+        }
+        res = ((Matrice*)element)->cholesky(lisp, (Matrice*)Y);
+        if (Y != NULL)
+            Y->release();
+        element->release();
+    }
+    catch (Error* err) {
+        if (Y != NULL)
+            Y->release();
+        element->release();
+        throw err;
+    }
+    return res;
+}
+
+Element* List::evall_qr(LispE* lisp) {
+    Element* element = liste[1]->eval(lisp);
+    Element* Y = NULL;
+    Element* res;
+
+    try {
+        if (element->type != t_matrix)
+            throw new Error("Error: 'qr' can only be applied to matrices");
+        if (liste.size() == 3) {
+            Y = liste[2]->eval(lisp);
+            if (Y->type != t_matrix)
+                throw new Error("Error: 'qr' can only be applied to matrices");
+        }
+        res = ((Matrice*)element)->qr(lisp, (Matrice*)Y);
+        if (Y != NULL)
+            Y->release();
+        element->release();
+    }
+    catch (Error* err) {
+        if (Y != NULL)
+            Y->release();
+        element->release();
+        throw err;
+    }
+    return res;
+}
+
 Element* List::evall_ludcmp(LispE* lisp) {
     Element* element = liste[1]->eval(lisp);
     if (element->type != t_matrix) {
@@ -10520,6 +11422,16 @@ long hcf_math(long x, long y) {
  Cette extension exporte la majorité des opérateurs mathématique
  */
 
+typedef double (*math_function)(double);
+
+static double radian_math(double v) {
+    return M_PI*(v / 180);
+}
+
+static double degree_math(double v) {
+    return (v * 180) / M_PI;
+}
+
 class Math : public Element {
 public:
     math m;
@@ -10531,9 +11443,134 @@ public:
         v_val = lisp->encode(val);
     }
     
+    math_function function() {
+        switch (m) {
+            case math_fabs:
+                return static_cast<math_function>(fabs);
+            case math_acos:
+                return static_cast<math_function>(acos);
+            case math_acosh:
+                return static_cast<math_function>(acosh);
+            case math_asin:
+                return static_cast<math_function>(asin);
+            case math_asinh:
+                return static_cast<math_function>(asinh);
+            case math_atan:
+                return static_cast<math_function>(atan);
+            case math_atanh:
+                return static_cast<math_function>(atanh);
+            case math_cbrt:
+                return static_cast<math_function>(cbrt);
+            case math_cos:
+                return static_cast<math_function>(cos);
+            case math_cosh:
+                return static_cast<math_function>(cosh);
+            case math_erf:
+                return static_cast<math_function>(erf);
+            case math_erfc:
+                return static_cast<math_function>(erfc);
+            case math_exp:
+                return static_cast<math_function>(exp);
+            case math_exp2:
+                return static_cast<math_function>(exp2);
+            case math_expm1:
+                return static_cast<math_function>(expm1);
+            case math_floor:
+                return static_cast<math_function>(floor);
+            case math_lgamma:
+                return static_cast<math_function>(lgamma);
+            case math_log:
+                return static_cast<math_function>(log);
+            case math_log10:
+                return static_cast<math_function>(log10);
+            case math_log1p:
+                return static_cast<math_function>(log1p);
+            case math_log2:
+                return static_cast<math_function>(log2);
+            case math_logb:
+                return static_cast<math_function>(logb);
+            case math_nearbyint:
+                return static_cast<math_function>(nearbyint);
+            case math_rint:
+                return static_cast<math_function>(rint);
+            case math_round:
+                return static_cast<math_function>(round);
+            case math_sin:
+                return static_cast<math_function>(sin);
+            case math_sinh:
+                return static_cast<math_function>(sinh);
+            case math_sqrt:
+                return static_cast<math_function>(sqrt);
+            case math_tan:
+                return static_cast<math_function>(tan);
+            case math_tanh:
+                return static_cast<math_function>(tanh);
+            case math_tgamma:
+                return static_cast<math_function>(tgamma);
+            case math_trunc:
+                return static_cast<math_function>(trunc);
+            case math_radian:
+                return radian_math;
+            case math_degree:
+                return degree_math;
+            default:
+                return NULL;
+        }
+    }
+    
+    //The function is applied to a whole numerical container in one single loop
+    //floats return floats, the other containers return numbers
+    Element* containers(LispE* lisp, Element* e, math_function f) {
+        long nb = e->size();
+        long i;
+        if (e->type == t_floats) {
+            Floats* res = lisp->provideFloats(nb, 0);
+            float* r = res->liste.items->buffer + res->liste.home;
+            float* values = ((Floats*)e)->liste.items->buffer + ((Floats*)e)->liste.home;
+            for (i = 0; i < nb; i++)
+                r[i] = f(values[i]);
+            return res;
+        }
+        
+        Numbers* res = lisp->provideNumbers(nb, 0);
+        double* r = res->liste.items->buffer + res->liste.home;
+        switch (e->type) {
+            case t_numbers: {
+                double* values = ((Numbers*)e)->liste.items->buffer + ((Numbers*)e)->liste.home;
+                for (i = 0; i < nb; i++)
+                    r[i] = f(values[i]);
+                break;
+            }
+            case t_integers: {
+                long* values = ((Integers*)e)->liste.items->buffer + ((Integers*)e)->liste.home;
+                for (i = 0; i < nb; i++)
+                    r[i] = f(values[i]);
+                break;
+            }
+            default: {
+                short* values = ((Shorts*)e)->liste.items->buffer + ((Shorts*)e)->liste.home;
+                for (i = 0; i < nb; i++)
+                    r[i] = f(values[i]);
+            }
+        }
+        return res;
+    }
+    
     Element* eval(LispE* lisp) {
         //eval is either: command, setenv or getenv...
         double v;
+        Element* e = lisp->get_variable(v_val);
+        switch (e->type) {
+            case t_floats:
+            case t_numbers:
+            case t_integers:
+            case t_shorts: {
+                math_function f = function();
+                if (f != NULL)
+                    return containers(lisp, e, f);
+            }
+        }
+        
         switch (m) {
             case math_fabs: {
                 v = lisp->get_variable(v_val)->asNumber();
@@ -10835,6 +11872,615 @@ public:
 };
 
 
+//------------------------------------------------------------------------------------------
+//Sparse matrices in CSR format (compressed sparse rows)
+//The values of row i are stored in: values[rows[i]..rows[i+1][, with their columns in columns
+//Within a row, columns are sorted and there is no explicit zero
+//The CSC representation of a matrix is the CSR of its transposition (see sparse_transpose)
+
+typedef enum {sparse_create, sparse_mult, sparse_transpose, sparse_rows, sparse_columns, sparse_dense,
+    sparse_triplets, sparse_shape, sparse_at, sparse_cg, sparse_bicgstab} sparse_action;
+
+//Below this number of values, sparse products are not split across threads
+const long sparse_threading = 1 << 20;
+//The row index of a sparse matrix is allocated upfront (one long per row)
+const long sparse_max_rows = 1L << 28;
+
+class Sparse;
+
+//We sort triplets on rows and columns
+typedef struct {
+    long i;
+    long j;
+    double v;
+} sparse_triplet;
+
+static bool sparse_compare(const sparse_triplet& a, const sparse_triplet& b) {
+    return (a.i < b.i || (a.i == b.i && a.j < b.j));
+}
+
+class Sparse : public Element {
+public:
+    long size_x, size_y;
+    std::vector<long> rows;
+    std::vector<long> columns;
+    std::vector<double> values;
+    
+    Sparse(short l_sparse, long x, long y) : size_x(x), size_y(y), rows(x + 1, 0), Element(l_sparse) {}
+    
+    long size() {
+        return size_x;
+    }
+    
+    long nnz() {
+        return values.size();
+    }
+    
+    //Triplets on the same cell are summed, zeros are removed
+    void build(std::vector<sparse_triplet>& triplets) {
+        for (long t = 0; t < triplets.size(); t++) {
+            if (triplets[t].i < 0 || triplets[t].i >= size_x || triplets[t].j < 0 || triplets[t].j >= size_y)
+                throw new Error("Error: index out of bounds in sparse matrix");
+        }
+        
+        std::sort(triplets.begin(), triplets.end(), sparse_compare);
+        long t = 0;
+        long i, j;
+        double v;
+        while (t < triplets.size()) {
+            i = triplets[t].i;
+            j = triplets[t].j;
+            v = triplets[t++].v;
+            while (t < triplets.size() && triplets[t].i == i && triplets[t].j == j)
+                v += triplets[t++].v;
+            if (v != 0) {
+                columns.push_back(j);
+                values.push_back(v);
+                rows[i + 1]++;
+            }
+        }
+        for (i = 0; i < size_x; i++)
+            rows[i + 1] += rows[i];
+    }
+    
+    double at(long i, long j) {
+        std::vector<long>::iterator b = columns.begin() + rows[i];
+        std::vector<long>::iterator e = columns.begin() + rows[i + 1];
+        std::vector<long>::iterator it = std::lower_bound(b, e, j);
+        if (it == e || *it != j)
+            return 0;
+        return values[it - columns.begin()];
+    }
+    
+    //y = this.x, on rows [ifirst, ilast[
+    static void product_rows(Sparse* a, double* x, double* y, long ifirst, long ilast) {
+        long* cols = a->columns.data();
+        double* vals = a->values.data();
+        double s;
+        long k, kmax;
+        for (long i = ifirst; i < ilast; i++) {
+            s = 0;
+            kmax = a->rows[i + 1];
+            for (k = a->rows[i]; k < kmax; k++)
+                s += vals[k] * x[cols[k]];
+            y[i] = s;
+        }
+    }
+    
+    //c = this.b, where b is a dense matrix, on rows [ifirst, ilast[
+    static void product_matrix_rows(Sparse* a, dense_matrix<double>* b, dense_matrix<double>* c, long ifirst, long ilast) {
+        long m = b->size_y;
+        long k, kmax;
+        for (long i = ifirst; i < ilast; i++) {
+            kmax = a->rows[i + 1];
+            for (k = a->rows[i]; k < kmax; k++)
+                gemm_row(c->row(i), b->row(a->columns[k]), a->values[k], 0, m);
+        }
+    }
+    
+    //Each thread works on slices of rows with the same number of values
+    void slices(vecte<long>& bounds, long nbthreads) {
+        long slice = (nnz() + nbthreads - 1) / nbthreads;
+        bounds.push_back(0);
+        long next = slice;
+        for (long i = 0; i < size_x; i++) {
+            if (rows[i + 1] >= next) {
+                bounds.push_back(i + 1);
+                next += slice;
+            }
+        }
+        if (bounds.back() != size_x)
+            bounds.push_back(size_x);
+    }
+    
+    void product(double* x, double* y) {
+        long nbthreads = std::thread::hardware_concurrency();
+        if (nbthreads <= 1 || size_x < 2*nbthreads || nnz() < sparse_threading) {
+            product_rows(this, x, y, 0, size_x);
+            return;
+        }
+        
+        vecte<long> bounds;
+        slices(bounds, nbthreads);
+        vecte<std::thread*> threads;
+        long i;
+        for (i = 0; i < bounds.size() - 1; i++)
+            threads.push_back(new std::thread(product_rows, this, x, y, bounds[i], bounds[i + 1]));
+        for (i = 0; i < threads.size(); i++) {
+            threads[i]->join();
+            delete threads[i];
+        }
+    }
+    
+    void product(dense_matrix<double>& b, dense_matrix<double>& c) {
+        long nbthreads = std::thread::hardware_concurrency();
+        if (nbthreads <= 1 || size_x < 2*nbthreads || nnz() * b.size_y < sparse_threading) {
+            product_matrix_rows(this, &b, &c, 0, size_x);
+            return;
+        }
+        
+        vecte<long> bounds;
+        slices(bounds, nbthreads);
+        vecte<std::thread*> threads;
+        long i;
+        for (i = 0; i < bounds.size() - 1; i++)
+            threads.push_back(new std::thread(product_matrix_rows, this, &b, &c, bounds[i], bounds[i + 1]));
+        for (i = 0; i < threads.size(); i++) {
+            threads[i]->join();
+            delete threads[i];
+        }
+    }
+    
+    //Counting sort on columns, the rows of the transposition are then already sorted
+    Sparse* transposition() {
+        Sparse* t = new Sparse(type, size_y, size_x);
+        long k, i;
+        for (k = 0; k < nnz(); k++)
+            t->rows[columns[k] + 1]++;
+        for (i = 0; i < size_y; i++)
+            t->rows[i + 1] += t->rows[i];
+        
+        t->columns.resize(nnz());
+        t->values.resize(nnz());
+        std::vector<long> position(t->rows.begin(), t->rows.end() - 1);
+        for (i = 0; i < size_x; i++) {
+            for (k = rows[i]; k < rows[i + 1]; k++) {
+                t->columns[position[columns[k]]] = i;
+                t->values[position[columns[k]]++] = values[k];
+            }
+        }
+        return t;
+    }
+    
+    //rows [from, to[
+    Sparse* row_slice(long from, long to) {
+        Sparse* s = new Sparse(type, to - from, size_y);
+        s->columns.assign(columns.begin() + rows[from], columns.begin() + rows[to]);
+        s->values.assign(values.begin() + rows[from], values.begin() + rows[to]);
+        for (long i = from; i <= to; i++)
+            s->rows[i - from] = rows[i] - rows[from];
+        return s;
+    }
+    
+    //columns [from, to[
+    Sparse* column_slice(long from, long to) {
+        Sparse* s = new Sparse(type, size_x, to - from);
+        std::vector<long>::iterator b, e;
+        long k;
+        for (long i = 0; i < size_x; i++) {
+            b = columns.begin() + rows[i];
+            e = columns.begin() + rows[i + 1];
+            for (k = std::lower_bound(b, e, from) - columns.begin(); k < rows[i + 1] && columns[k] < to; k++) {
+                s->columns.push_back(columns[k] - from);
+                s->values.push_back(values[k]);
+            }
+            s->rows[i + 1] = s->values.size();
+        }
+        return s;
+    }
+    
+    Element* dense(LispE* lisp) {
+        Matrice* m = new Matrice(lisp, size_x, size_y, 0.0);
+        Numbers* row;
+        for (long i = 0; i < size_x; i++) {
+            row = (Numbers*)m->liste[i];
+            for (long k = rows[i]; k < rows[i + 1]; k++)
+                row->liste[columns[k]] = values[k];
+        }
+        return m;
+    }
+    
+    Element* triplets(LispE* lisp) {
+        List* res = lisp->provideList();
+        List* triplet;
+        for (long i = 0; i < size_x; i++) {
+            for (long k = rows[i]; k < rows[i + 1]; k++) {
+                triplet = lisp->provideList();
+                triplet->append(lisp->provideInteger(i));
+                triplet->append(lisp->provideInteger(columns[k]));
+                triplet->append(lisp->provideNumber(values[k]));
+                res->append(triplet);
+            }
+        }
+        return res;
+    }
+    
+    wstring asString(LispE* lisp) {
+        std::wstringstream s;
+        s << L"sparse(" << size_x << L"x" << size_y << L", " << nnz() << L")";
+        return s.str();
+    }
+    
+    u_ustring asUString(LispE* lisp) {
+        wstring w = asString(lisp);
+        return _w_to_u(w);
+    }
+};
+
+static double sparse_dot(std::vector<double>& a, std::vector<double>& b) {
+    double s = 0;
+    for (long i = 0; i < a.size(); i++)
+        s += a[i] * b[i];
+    return s;
+}
+
+//Conjugate gradient, for symmetric positive definite matrices
+static bool sparse_conjugate_gradient(Sparse* a, std::vector<double>& b, std::vector<double>& x, double tolerance, long iterations) {
+    long n = b.size();
+    std::vector<double> r(b);
+    std::vector<double> p(b);
+    std::vector<double> ap(n);
+    double threshold = tolerance * sqrt(sparse_dot(b, b));
+    double rs = sparse_dot(r, r);
+    double alpha, rsnew;
+    long i;
+    
+    if (sqrt(rs) <= threshold)
+        return true;
+
+    for (long it = 0; it < iterations; it++) {
+        a->product(p.data(), ap.data());
+        alpha = sparse_dot(p, ap);
+        if (alpha == 0)
+            return false;
+        alpha = rs / alpha;
+        for (i = 0; i < n; i++) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * ap[i];
+        }
+        rsnew = sparse_dot(r, r);
+        if (sqrt(rsnew) <= threshold)
+            return true;
+        for (i = 0; i < n; i++)
+            p[i] = r[i] + (rsnew / rs) * p[i];
+        rs = rsnew;
+    }
+    return false;
+}
+
+//Biconjugate gradient stabilized, for any invertible square matrix
+static bool sparse_biconjugate_gradient(Sparse* a, std::vector<double>& b, std::vector<double>& x, double tolerance, long iterations) {
+    long n = b.size();
+    std::vector<double> r(b);
+    std::vector<double> r0(b);
+    std::vector<double> p(n, 0);
+    std::vector<double> v(n, 0);
+    std::vector<double> s(n);
+    std::vector<double> t(n);
+    double threshold = tolerance * sqrt(sparse_dot(b, b));
+    double rho = 1, alpha = 1, omega = 1;
+    double rhonew, beta;
+    long i;
+    
+    if (sqrt(sparse_dot(r, r)) <= threshold)
+        return true;
+    
+    for (long it = 0; it < iterations; it++) {
+        rhonew = sparse_dot(r0, r);
+        if (rhonew == 0 || omega == 0)
+            return false;
+        beta = (rhonew / rho) * (alpha / omega);
+        for (i = 0; i < n; i++)
+            p[i] = r[i] + beta * (p[i] - omega * v[i]);
+        a->product(p.data(), v.data());
+        alpha = sparse_dot(r0, v);
+        if (alpha == 0)
+            return false;
+        alpha = rhonew / alpha;
+        for (i = 0; i < n; i++)
+            s[i] = r[i] - alpha * v[i];
+        if (sqrt(sparse_dot(s, s)) <= threshold) {
+            for (i = 0; i < n; i++)
+                x[i] += alpha * p[i];
+            return true;
+        }
+        a->product(s.data(), t.data());
+        omega = sparse_dot(t, t);
+        if (omega == 0)
+            return false;
+        omega = sparse_dot(t, s) / omega;
+        for (i = 0; i < n; i++) {
+            x[i] += alpha * p[i] + omega * s[i];
+            r[i] = s[i] - omega * t[i];
+        }
+        if (sqrt(sparse_dot(r, r)) <= threshold)
+            return true;
+        rho = rhonew;
+    }
+    return false;
+}
+
+class SparseMatrix : public Element {
+public:
+    sparse_action action;
+    short l_sparse;
+    
+    SparseMatrix(LispE* lisp, sparse_action a) : action(a), Element(l_lib) {
+        u_ustring w = U"sparse_";
+        l_sparse = lisp->encode(w);
+    }
+    
+    Sparse* sparse(Element* e) {
+        if (e->type != l_sparse)
+            throw new Error("Error: the first element must be a sparse matrix");
+        return (Sparse*)e;
+    }
+    
+    void row_triplets(long i, Element* line, std::vector<sparse_triplet>& values, long& my) {
+        sparse_triplet t;
+        t.i = i;
+        if (line->type == t_dictionaryi) {
+            for (const auto& a : ((Dictionary_i*)line)->dictionary) {
+                t.j = a.first;
+                t.v = a.second->asNumber();
+                values.push_back(t);
+                my = std::max(my, t.j + 1);
+            }
+            return;
+        }
+        if (line->type == t_dictionaryn) {
+            for (const auto& a : ((Dictionary_n*)line)->dictionary) {
+                t.j = (long)a.first;
+                t.v = a.second->asNumber();
+                values.push_back(t);
+                my = std::max(my, t.j + 1);
+            }
+            return;
+        }
+        throw new Error("Error: expecting a dictionary of dictionaries with numerical keys");
+    }
+    
+    //Triplets are either a list of (i j v), a dictionary {i:{j:v}} or a dense matrix
+    void triplets(LispE* lisp, Element* data, std::vector<sparse_triplet>& values, long& nx, long& ny) {
+        sparse_triplet t;
+        long mx = 0, my = 0;
+        long i, j;
+        
+        if (data->type == t_dictionaryi) {
+            for (const auto& a : ((Dictionary_i*)data)->dictionary) {
+                row_triplets(a.first, a.second, values, my);
+                mx = std::max(mx, a.first + 1);
+            }
+        }
+        else if (data->type == t_dictionaryn) {
+            for (const auto& a : ((Dictionary_n*)data)->dictionary) {
+                row_triplets((long)a.first, a.second, values, my);
+                mx = std::max(mx, (long)a.first + 1);
+            }
+        }
+        else {
+            if (!data->isList())
+                throw new Error("Error: expecting a list of triplets, a dictionary or a matrix");
+            
+            long x, y;
+            if (data->isPureList(x, y) && (data->type == t_matrix || data->type == t_matrix_float)) {
+                mx = x;
+                my = y;
+                for (i = 0; i < x; i++) {
+                    for (j = 0; j < y; j++) {
+                        t.v = data->index(i)->index(j)->asNumber();
+                        if (t.v != 0) {
+                            t.i = i;
+                            t.j = j;
+                            values.push_back(t);
+                        }
+                    }
+                }
+            }
+            else {
+                Element* triplet;
+                for (i = 0; i < data->size(); i++) {
+                    triplet = data->index(i);
+                    if (!triplet->isList() || triplet->size() != 3)
+                        throw new Error("Error: expecting a list of triplets: (row column value)");
+                    t.i = triplet->index(0)->asInteger();
+                    t.j = triplet->index(1)->asInteger();
+                    t.v = triplet->index(2)->asNumber();
+                    values.push_back(t);
+                    mx = std::max(mx, t.i + 1);
+                    my = std::max(my, t.j + 1);
+                }
+            }
+        }
+        
+        if (nx == -1)
+            nx = mx;
+        if (ny == -1)
+            ny = my;
+        if (nx < mx || ny < my)
+            throw new Error("Error: the dimensions of the sparse matrix are too small for its values");
+    }
+    
+    //The dimensions come from the user, they are checked before any allocation
+    Sparse* sparse_matrix(std::vector<sparse_triplet>& values, long nx, long ny) {
+        if (nx < 0 || ny < 0)
+            throw new Error("Error: the dimensions of a sparse matrix cannot be negative");
+        //The transposition of the matrix has ny rows
+        if (nx >= sparse_max_rows || ny >= sparse_max_rows)
+            throw new Error("Error: the dimensions of the sparse matrix are too large");
+        
+        Sparse* s = new Sparse(l_sparse, nx, ny);
+        try {
+            s->build(values);
+        }
+        catch (Error* err) {
+            delete s;
+            throw err;
+        }
+        return s;
+    }
+    
+    //A sparse matrix or a dense matrix, which is then converted
+    Sparse* operand(LispE* lisp, Element* e) {
+        if (e->type == l_sparse)
+            return (Sparse*)e;
+        if (e->type != t_matrix && e->type != t_matrix_float)
+            throw new Error("Error: expecting a sparse matrix or a matrix");
+        long nx = -1, ny = -1;
+        std::vector<sparse_triplet> values;
+        triplets(lisp, e, values, nx, ny);
+        return sparse_matrix(values, nx, ny);
+    }
+    
+    Element* solving(LispE* lisp, Element* m, Element* b, bool symmetric) {
+        Sparse* a = operand(lisp, m);
+        if (a->size_x != a->size_y || b->size() != a->size_x) {
+            if (a != m)
+                delete a;
+            throw new Error("Error: expecting a square matrix and a vector of the same size");
+        }
+        
+        double tolerance = lisp->get_variable(U"tolerance")->asNumber();
+        long iterations = lisp->get_variable(U"iterations")->asInteger();
+        if (iterations <= 0)
+            iterations = 10 * a->size_x;
+        
+        std::vector<double> y(a->size_x);
+        std::vector<double> x(a->size_x, 0);
+        for (long i = 0; i < a->size_x; i++)
+            y[i] = b->index(i)->asNumber();
+        
+        bool converged;
+        if (symmetric)
+            converged = sparse_conjugate_gradient(a, y, x, tolerance, iterations);
+        else
+            converged = sparse_biconjugate_gradient(a, y, x, tolerance, iterations);
+        if (a != m)
+            delete a;
+        
+        if (!converged)
+            throw new Error("Error: the iterative solver did not converge");
+        
+        Numbers* res = lisp->provideNumbers(x.size(), 0);
+        res->liste.assign(x.data(), x.size());
+        return res;
+    }
+    
+    Element* eval(LispE* lisp) {
+        switch (action) {
+            case sparse_create: {
+                Element* data = lisp->get_variable(U"content");
+                long nx = lisp->get_variable(U"nx")->asInteger();
+                long ny = lisp->get_variable(U"ny")->asInteger();
+                std::vector<sparse_triplet> values;
+                triplets(lisp, data, values, nx, ny);
+                return sparse_matrix(values, nx, ny);
+            }
+            case sparse_mult: {
+                Sparse* s = sparse(lisp->get_variable(U"m"));
+                Element* x = lisp->get_variable(U"x");
+                long nx, ny;
+                if (x->isPureList(nx, ny) && (x->type == t_matrix || x->type == t_matrix_float)) {
+                    if (nx != s->size_y)
+                        throw new Error("Error: size mismatch in sparse product");
+                    dense_matrix<double> b(nx, ny);
+                    dense_matrix<double> c(s->size_x, ny);
+                    dense_double(x, b);
+                    s->product(b, c);
+                    return new Matrice(lisp, c);
+                }
+                if (!x->isList() || x->size() != s->size_y)
+                    throw new Error("Error: size mismatch in sparse product");
+                std::vector<double> v(s->size_y);
+                for (long i = 0; i < s->size_y; i++)
+                    v[i] = x->index(i)->asNumber();
+                Numbers* res = lisp->provideNumbers(s->size_x, 0);
+                s->product(v.data(), res->liste.items->buffer + res->liste.home);
+                return res;
+            }
+            case sparse_transpose:
+                return sparse(lisp->get_variable(U"m"))->transposition();
+            case sparse_rows:
+            case sparse_columns: {
+                Sparse* s = sparse(lisp->get_variable(U"m"));
+                long mx = (action == sparse_rows)?s->size_x:s->size_y;
+                long from = lisp->get_variable(U"from")->asInteger();
+                long to = lisp->get_variable(U"to")->asInteger();
+                if (to == -1)
+                    to = mx;
+                if (from < 0 || from > to || to > mx)
+                    throw new Error("Error: index out of bounds in sparse matrix");
+                if (action == sparse_rows)
+                    return s->row_slice(from, to);
+                return s->column_slice(from, to);
+            }
+            case sparse_dense:
+                return sparse(lisp->get_variable(U"m"))->dense(lisp);
+            case sparse_triplets:
+                return sparse(lisp->get_variable(U"m"))->triplets(lisp);
+            case sparse_shape: {
+                Sparse* s = sparse(lisp->get_variable(U"m"));
+                Integers* res = lisp->provideIntegers();
+                res->liste.push_back(s->size_x);
+                res->liste.push_back(s->size_y);
+                res->liste.push_back(s->nnz());
+                return res;
+            }
+            case sparse_at: {
+                Sparse* s = sparse(lisp->get_variable(U"m"));
+                long i = lisp->get_variable(U"i")->asInteger();
+                long j = lisp->get_variable(U"j")->asInteger();
+                if (i < 0 || i >= s->size_x || j < 0 || j >= s->size_y)
+                    throw new Error("Error: index out of bounds in sparse matrix");
+                return lisp->provideNumber(s->at(i, j));
+            }
+            case sparse_cg:
+                return solving(lisp, lisp->get_variable(U"m"), lisp->get_variable(U"b"), true);
+            case sparse_bicgstab:
+                return solving(lisp, lisp->get_variable(U"m"), lisp->get_variable(U"b"), false);
+        }
+        return null_;
+    }
+    
+    wstring asString(LispE* lisp) {
+        switch (action) {
+            case sparse_create:
+                return L"Creates a sparse matrix from a list of triplets (row column value), a dictionary {row:{column:value}} or a matrix";
+            case sparse_mult:
+                return L"Multiplies a sparse matrix with a vector or a matrix";
+            case sparse_transpose:
+                return L"Transposes a sparse matrix";
+            case sparse_rows:
+                return L"Returns the rows [from, to[ of a sparse matrix";
+            case sparse_columns:
+                return L"Returns the columns [from, to[ of a sparse matrix";
+            case sparse_dense:
+                return L"Converts a sparse matrix into a matrix";
+            case sparse_triplets:
+                return L"Returns the list of triplets (row column value) of a sparse matrix";
+            case sparse_shape:
+                return L"Returns the number of rows, of columns and of non-zero values of a sparse matrix";
+            case sparse_at:
+                return L"Returns the value at row i and column j";
+            case sparse_cg:
+                return L"Solves m.x = b with a conjugate gradient, m being symmetric positive definite";
+            case sparse_bicgstab:
+                return L"Solves m.x = b with a biconjugate gradient stabilized method";
+        }
+        return L"";
+    }
+};
+
 //We are also going to implement the body of the call
 void moduleMaths(LispE* lisp) {
     //We first create the body of the function
@@ -10877,6 +12523,18 @@ void moduleMaths(LispE* lisp) {
     lisp->extension("deflib radian (val)", new Math(lisp, math_radian));
     lisp->extension("deflib degree (val)", new Math(lisp, math_degree));
 
+    lisp->extension("deflib sparse (content (nx -1) (ny -1))", new SparseMatrix(lisp, sparse_create));
+    lisp->extension("deflib sparse_mult (m x)", new SparseMatrix(lisp, sparse_mult));
+    lisp->extension("deflib sparse_transpose (m)", new SparseMatrix(lisp, sparse_transpose));
+    lisp->extension("deflib sparse_rows (m from (to -1))", new SparseMatrix(lisp, sparse_rows));
+    lisp->extension("deflib sparse_columns (m from (to -1))", new SparseMatrix(lisp, sparse_columns));
+    lisp->extension("deflib sparse_dense (m)", new SparseMatrix(lisp, sparse_dense));
+    lisp->extension("deflib sparse_triplets (m)", new SparseMatrix(lisp, sparse_triplets));
+    lisp->extension("deflib sparse_shape (m)", new SparseMatrix(lisp, sparse_shape));
+    lisp->extension("deflib sparse_at (m i j)", new SparseMatrix(lisp, sparse_at));
+    lisp->extension("deflib sparse_cg (m b (tolerance 0.0000000001) (iterations 0))", new SparseMatrix(lisp, sparse_cg));
+    lisp->extension("deflib sparse_bicgstab (m b (tolerance 0.0000000001) (iterations 0))", new SparseMatrix(lisp, sparse_bicgstab));
+
     u_ustring nom = U"_pi";
     Element* value = lisp->provideNumber(M_PI);
     lisp->recordingunique(value, lisp->encode(nom));
@@ -44,6 +44,14 @@ using std::wsregex_iterator;
 
 #include "rgx.h"
 
+#ifdef INTELINTRINSICS
+#ifdef WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
 static Au_automatons* gAutomatons = NULL;
 
 //--------------------------------------------------------------------
@@ -253,10 +261,402 @@ bool Au_state::match(u_ustring& w, long i) {
     return false;
 }
 
+//----------------------------------------------------------------
+//Lazy DFA: states are built on demand through a subset construction
+Au_dfa::Au_dfa(Au_state* first) {
+    limit = au_dfa_limit;
+    overflow = false;
+    filtering = false;
+    unanchored = false;
+    vector<Au_state*> kernel;
+    //state 0 is the dead state
+    state(kernel);
+    for (long i = 0; i < au_dfa_ascii; i++)
+        states[0]->ascii[i] = 0;
+    
+    kernel.push_back(first);
+    state(kernel);
+    prefiltering();
+    filtering = (prefix.size() || initials.size());
+}
+
+//A DFA over a set of automatons. When unanchored, the initial states are added
+//to every closure: state 0 is then the starting state and there is no dead state.
+Au_dfa::Au_dfa(vector<Au_automate*>& automatons, bool u) {
+    limit = au_dfa_set_limit;
+    overflow = false;
+    filtering = false;
+    unanchored = u;
+    long i, j;
+    for (i = 0; i < automatons.size(); i++) {
+        starts.push_back(automatons[i]->first);
+        owners[automatons[i]->first] = i;
+        for (j = 0; j < automatons[i]->garbage.states.last; j++) {
+            if (automatons[i]->garbage.states[j] != NULL)
+                owners[automatons[i]->garbage.states[j]] = i;
+        }
+    }
+    std::sort(starts.begin(), starts.end());
+    
+    vector<Au_state*> kernel;
+    state(kernel);
+    if (unanchored)
+        return;
+    
+    for (i = 0; i < au_dfa_ascii; i++)
+        states[0]->ascii[i] = 0;
+    state(starts);
+}
+
+//kernel is sorted, we return the index of the corresponding DFA state
+long Au_dfa::state(vector<Au_state*>& kernel) {
+    std::map<vector<Au_state*>, long>::iterator it = indexes.find(kernel);
+    if (it != indexes.end())
+        return it->second;
+    
+    if (states.size() >= limit) {
+        overflow = true;
+        return au_error;
+    }
+    
+    Au_dfa_state* st = new Au_dfa_state(kernel);
+    Au_state* s;
+    Au_state* a;
+    std::unordered_map<Au_state*, long>::iterator owner;
+    long i, j, k;
+    
+    //the closure contains the states that can be reached through epsilon arcs
+    st->closure = kernel;
+    if (unanchored) {
+        for (i = 0; i < starts.size(); i++) {
+            if (!std::binary_search(kernel.begin(), kernel.end(), starts[i]))
+                st->closure.push_back(starts[i]);
+        }
+    }
+    
+    for (i = 0; i < st->closure.size(); i++) {
+        s = st->closure[i];
+        if (s->isend()) {
+            st->reachable = true;
+            owner = owners.find(s);
+            if (owner != owners.end())
+                st->rules.push_back(owner->second);
+            if (i < kernel.size()) {
+                st->final = true;
+                if (owner != owners.end())
+                    st->finals.push_back(owner->second);
+            }
+        }
+        
+        for (j = 0; j < s->arcs.last; j++) {
+            if (s->arcs[j]->Type() != an_epsilon)
+                continue;
+            a = s->arcs[j]->state;
+            if ((a->status & an_error) == an_error)
+                continue;
+            for (k = 0; k < st->closure.size(); k++) {
+                if (st->closure[k] == a)
+                    break;
+            }
+            if (k == st->closure.size())
+                st->closure.push_back(a);
+        }
+    }
+    
+    std::sort(st->rules.begin(), st->rules.end());
+    st->rules.erase(std::unique(st->rules.begin(), st->rules.end()), st->rules.end());
+    std::sort(st->finals.begin(), st->finals.end());
+    st->finals.erase(std::unique(st->finals.begin(), st->finals.end()), st->finals.end());
+    
+    long idx = states.size();
+    states.push_back(st);
+    indexes[kernel] = idx;
+    return idx;
+}
+
+long Au_dfa::transition(long s, UWCHAR c) {
+    Au_dfa_state* st = states[s];
+    if (c >= au_dfa_ascii) {
+        std::unordered_map<UWCHAR, long>::iterator it = st->others.find(c);
+        if (it != st->others.end())
+            return it->second;
+    }
+    else {
+        if (st->ascii[c] != au_error)
+            return st->ascii[c];
+    }
+    
+    vector<Au_state*> kernel;
+    Au_state* a;
+    long i, j;
+    for (i = 0; i < st->closure.size(); i++) {
+        for (j = 0; j < st->closure[i]->arcs.last; j++) {
+            if (st->closure[i]->arcs[j]->action->compare(c) == 1) {
+                a = st->closure[i]->arcs[j]->state;
+                if ((a->status & an_error) != an_error)
+                    kernel.push_back(a);
+            }
+        }
+    }
+    
+    std::sort(kernel.begin(), kernel.end());
+    kernel.erase(std::unique(kernel.begin(), kernel.end()), kernel.end());
+    
+    long next = state(kernel);
+    if (next == au_error)
+        return au_error;
+    
+    if (c >= au_dfa_ascii)
+        st->others[c] = next;
+    else
+        st->ascii[c] = next;
+    return next;
+}
+
+//We follow the DFA from its initial state as long as a single character can be read
+//These characters form a prefix that every match must start with.
+//If the first step already offers a few characters, they are kept in initials.
+#define au_dfa_initials 4
+#define au_dfa_prefix 64
+void Au_dfa::prefiltering() {
+    Au_dfa_state* st;
+    Au_arc* a;
+    Au_char* ch;
+    u_ustring chars;
+    long s = 1;
+    long i, j;
+    
+    while (prefix.size() < au_dfa_prefix) {
+        st = states[s];
+        //the match might stop here
+        if (st->reachable)
+            return;
+        
+        chars.clear();
+        for (i = 0; i < st->closure.size(); i++) {
+            for (j = 0; j < st->closure[i]->arcs.last; j++) {
+                a = st->closure[i]->arcs[j];
+                if (a->Type() == an_epsilon)
+                    continue;
+                ch = dynamic_cast<Au_char*>(a->action);
+                //only plain characters: emojis might be followed with complements
+                if (ch == NULL || !ch->vero || Au_meta::met->c_is_emoji(ch->action))
+                    return;
+                if (chars.find(ch->action) == string::npos)
+                    chars += ch->action;
+            }
+        }
+        
+        if (chars.size() != 1) {
+            if (!prefix.size() && chars.size() <= au_dfa_initials)
+                initials = chars;
+            return;
+        }
+        
+        prefix += chars[0];
+        s = transition(s, chars[0]);
+        if (s <= 0)
+            return;
+    }
+}
+
+//Position of the next character in w from i that belongs to cs
+static long find_initials(UWCHAR* w, long i, long sz, UWCHAR* cs, long nb) {
+    long k;
+#ifdef INTELINTRINSICS
+    __m256i v[au_dfa_initials];
+    __m256i d, m;
+    int mask;
+    for (k = 0; k < nb; k++)
+        v[k] = _mm256_set1_epi32(cs[k]);
+    for (; i + 8 <= sz; i += 8) {
+        d = _mm256_loadu_si256((__m256i*)(w + i));
+        m = _mm256_cmpeq_epi32(d, v[0]);
+        for (k = 1; k < nb; k++)
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi32(d, v[k]));
+        mask = _mm256_movemask_ps(_mm256_castsi256_ps(m));
+        if (mask) {
+            for (k = 0; !(mask & (1 << k)); k++) {}
+            return i + k;
+        }
+    }
+#endif
+    for (; i < sz; i++) {
+        for (k = 0; k < nb; k++) {
+            if (w[i] == cs[k])
+                return i;
+        }
+    }
+    return sz;
+}
+
+//Next position from i, where a match might start
+long Au_dfa::next(u_ustring& w, long i) {
+    long sz = w.size();
+    if (i < 0 || i >= sz)
+        return i;
+    
+    UWCHAR* buffer = (UWCHAR*)w.c_str();
+    if (initials.size())
+        return find_initials(buffer, i, sz, (UWCHAR*)initials.c_str(), initials.size());
+    
+    long nb = prefix.size();
+    if (!nb)
+        return i;
+
+    UWCHAR* p = (UWCHAR*)prefix.c_str();
+    long j;
+    while (i + nb <= sz) {
+        i = find_initials(buffer, i, sz - nb + 1, p, 1);
+        if (i + nb > sz)
+            break;
+        for (j = 1; j < nb && buffer[i + j] == p[j]; j++) {}
+        if (j == nb)
+            return i;
+        i++;
+    }
+    return sz;
+}
+
+//Returns 1 if w is recognized, 0 if not and 2 if the DFA could not decide
+char Au_dfa::match(u_ustring& w) {
+    long sz = w.size();
+    long s = 1;
+    long j;
+    UWCHAR c;
+    for (long i = 0; i < sz; i++) {
+        c = w[i];
+        if (c < au_dfa_ascii && states[s]->ascii[c] != au_error)
+            s = states[s]->ascii[c];
+        else {
+            j = i;
+            c = Au_meta::met->getachar(w, j);
+            //emoji sequences are handled by the Au_state traversal
+            if (j != i)
+                return 2;
+            s = transition(s, c);
+            if (s == au_error)
+                return 2;
+        }
+        if (!s)
+            return 0;
+    }
+    return states[s]->final;
+}
+
+//Returns false if no match can start at position i
+//When it returns true, Au_state::loop provides the actual match
+bool Au_dfa::possible(u_ustring& w, long i) {
+    long sz = w.size();
+    long s = 1;
+    long j;
+    UWCHAR c;
+    while (i < sz) {
+        if (states[s]->reachable)
+            return true;
+        c = w[i];
+        if (c < au_dfa_ascii && states[s]->ascii[c] != au_error)
+            s = states[s]->ascii[c];
+        else {
+            j = i;
+            c = Au_meta::met->getachar(w, j);
+            if (j != i)
+                return true;
+            s = transition(s, c);
+            if (s == au_error)
+                return true;
+        }
+        if (!s)
+            return false;
+        i++;
+    }
+    return states[s]->final;
+}
+
+//Set of automatons: found[i] is set for each automaton that recognizes w
+//Returns false if the DFA could not decide
+bool Au_dfa::matches(u_ustring& w, vector<char>& found) {
+    long sz = w.size();
+    long s = 1;
+    long i, j;
+    UWCHAR c;
+    for (i = 0; i < sz; i++) {
+        c = w[i];
+        if (c < au_dfa_ascii && states[s]->ascii[c] != au_error)
+            s = states[s]->ascii[c];
+        else {
+            j = i;
+            c = Au_meta::met->getachar(w, j);
+            if (j != i)
+                return false;
+            s = transition(s, c);
+            if (s == au_error)
+                return false;
+        }
+        if (!s)
+            return true;
+    }
+    
+    for (i = 0; i < states[s]->finals.size(); i++)
+        found[states[s]->finals[i]] = 1;
+    return true;
+}
+
+//Unanchored set of automatons: in one pass over w, found[i] is set for each automaton
+//that might have a match in w. Automatons that are not marked have none.
+//Returns false if the DFA could not decide
+bool Au_dfa::candidates(u_ustring& w, vector<char>& found) {
+    long sz = w.size();
+    long s = 0;
+    long i, j;
+    UWCHAR c;
+    
+    for (i = 0; i < states[s]->rules.size(); i++)
+        found[states[s]->rules[i]] = 1;
+
+    for (i = 0; i < sz; i++) {
+        c = w[i];
+        if (c < au_dfa_ascii && states[s]->ascii[c] != au_error)
+            s = states[s]->ascii[c];
+        else {
+            j = i;
+            c = Au_meta::met->getachar(w, j);
+            if (j != i)
+                return false;
+            s = transition(s, c);
+            if (s == au_error)
+                return false;
+        }
+        for (j = 0; j < states[s]->rules.size(); j++)
+            found[states[s]->rules[j]] = 1;
+    }
+    return true;
+}
+
 bool Au_automaton::match(u_ustring& w) {
+    if (dfa != NULL && !dfa->overflow) {
+        dfa->lock.lock();
+        char m = dfa->match(w);
+        dfa->lock.unlock();
+        if (m != 2)
+            return m;
+    }
     return first->match(w,0);
 }
 
+//Returns the end of the match starting at i or au_error
+//The DFA discards the positions where no match can start without backtracking
+long Au_automaton::scan(u_ustring& w, long i) {
+    if (dfa != NULL && !dfa->overflow) {
+        dfa->lock.lock();
+        bool p = dfa->possible(w, i);
+        dfa->lock.unlock();
+        if (!p)
+            return au_error;
+    }
+    return first->loop(w,i);
+}
+
 //----------------------------------------------------------------
 
 void Au_state::storerulearcs(std::unordered_map<long,bool>& rules) {
@@ -325,8 +725,8 @@ long Au_state::loop(u_ustring& w, long i) {
 
 long Au_automaton::find(u_ustring& w) {
     long sz = w.size();
-    for (long d=0;d<sz;d++) {
-        if (first->loop(w,d) != au_error) {
+    for (long d=skip(w,0);d<sz;d=skip(w,d+1)) {
+        if (scan(w,d) != au_error) {
             return d;
         }
     }
@@ -335,8 +735,8 @@ long Au_automaton::find(u_ustring& w) {
 
 long Au_automaton::find(u_ustring& w, long i) {
     long sz = w.size();
-    for (long d = i ; d < sz; d++) {
-        if (first->loop(w,d) != au_error) {
+    for (long d = skip(w,i) ; d < sz; d = skip(w,d+1)) {
+        if (scan(w,d) != au_error) {
             return d;
         }
     }
@@ -345,8 +745,8 @@ long Au_automaton::find(u_ustring& w, long i) {
 
 bool Au_automaton::search(u_ustring& w) {
     long sz = w.size();
-    for (long d=0;d<sz;d++) {
-        if (first->loop(w,d) != au_error)
+    for (long d=skip(w,0);d<sz;d=skip(w,d+1)) {
+        if (scan(w,d) != au_error)
             return true;
     }
     return false;
@@ -354,8 +754,8 @@ bool Au_automaton::search(u_ustring& w) {
 
 bool Au_automaton::search(u_ustring& w, long& b, long& e, long init) {
     long sz = w.size();
-    for (b=init;b<sz;b++) {
-        e=first->loop(w,b);
+    for (b=skip(w,init);b<sz;b=skip(w,b+1)) {
+        e=scan(w,b);
         if (e != au_error) {
             return true;
         }
@@ -368,8 +768,8 @@ bool Au_automaton::searchlast(u_ustring& w, long& b, long& e, long init) {
     b=au_error;
     long f;
     long sz = w.size();
-    for (long d=init;d<sz;d++) {
-        f=first->loop(w,d);
+    for (long d=skip(w,init);d<sz;d=skip(w,d+1)) {
+        f=scan(w,d);
         if (f!=au_error) {
             b=d;
             e=f;
@@ -389,8 +789,8 @@ void Au_automaton::searchall(u_ustring& w, vecte_a<long>& res, long init) {
     long f;
     long sz = w.size();
     
-    for (long d=init;d<sz;d++) {
-        f=first->loop(w,d);
+    for (long d=skip(w,init);d<sz;d=skip(w,d+1)) {
+        f=scan(w,d);
         if (f!=au_error) {
             res.push_back(d);
             res.push_back(f);
@@ -457,8 +857,8 @@ bool Au_state::find(u_ustring& w, u_ustring& wsep, long i, vector<long>& res) {
 //This is used in LispEregularexpression::in
 bool Au_automaton::bytesearch(u_ustring& w, long& b, long& e) {
     long sz = w.size();
-    for (b=0; b<sz; b++) {
-        e=first->loop(w,b);
+    for (b=skip(w,0); b<sz; b=skip(w,b+1)) {
+        e=scan(w,b);
         if (e!=au_error)
             return true;
     }
@@ -470,8 +870,8 @@ bool Au_automaton::bytesearch(u_ustring& w, long& b, long& e) {
 void Au_automaton::bytesearchall(u_ustring& w, vecte_a<long>& res) {
     long f;
     long sz = w.size();
-    for (long d=0; d<sz; d++) {
-        f=first->loop(w,d);
+    for (long d=skip(w,0); d<sz; d=skip(w,d+1)) {
+        f=scan(w,d);
         if (f!=au_error) {
             res.push_back(d);
             res.push_back(f);
@@ -537,6 +937,7 @@ Au_automate::Au_automate(wstring& wrgx) {
 
 Au_automaton::Au_automaton(u_ustring wrgx) {
     first=NULL;
+    dfa=NULL;
     if (!parse(wrgx))
         first = NULL;
 }
@@ -575,6 +976,8 @@ bool Au_automaton::parse(u_ustring& w, Au_automatons* aus) {
     
     //we delete the elements that have been marked for deletion...
     aus->clean(sb,ab);
+    reset();
+    dfa = new Au_dfa(first);
     return true;
 }
 
@@ -606,6 +1009,8 @@ bool Au_automate::compiling(u_ustring& w,long r) {
     first->merge(&base);
     
     garbage.clean(sb,ab);
+    reset();
+    dfa = new Au_dfa(first);
     return true;
 }
 
@@ -1071,6 +1476,133 @@ public:
     }
 };
 
+//A set of regular expressions, which are all evaluated in a single pass over a string
+//The unanchored DFA finds the expressions that might have a match, which are then checked one by one
+class LispERegularExpressionSet : public Element {
+public:
+    
+    vector<Au_automate*> automatons;
+    vector<u_ustring> patterns;
+    Au_dfa* searching;
+    Au_dfa* matching;
+    
+    LispERegularExpressionSet(short l_rgxset) : Element(l_rgxset) {
+        searching = NULL;
+        matching = NULL;
+    }
+    
+    ~LispERegularExpressionSet() {
+        for (long i = 0; i < automatons.size(); i++)
+            delete automatons[i];
+        if (searching != NULL)
+            delete searching;
+        if (matching != NULL)
+            delete matching;
+    }
+    
+    bool add(u_ustring& w) {
+        Au_automate* au = new Au_automate(w);
+        if (au->first == NULL) {
+            delete au;
+            return false;
+        }
+        automatons.push_back(au);
+        patterns.push_back(w);
+        return true;
+    }
+    
+    void compile() {
+        searching = new Au_dfa(automatons, true);
+        matching = new Au_dfa(automatons, false);
+    }
+    
+    void candidates(u_ustring& w, vector<char>& found) {
+        found.resize(automatons.size(), 0);
+        if (!searching->overflow) {
+            searching->lock.lock();
+            bool decided = searching->candidates(w, found);
+            searching->lock.unlock();
+            if (decided)
+                return;
+        }
+        for (long i = 0; i < found.size(); i++)
+            found[i] = 1;
+    }
+    
+    Element* find(LispE* lisp, u_ustring& w) {
+        vector<char> found;
+        candidates(w, found);
+        Integers* res = lisp->provideIntegers();
+        for (long i = 0; i < found.size(); i++) {
+            if (found[i] && automatons[i]->search(w))
+                res->liste.push_back(i);
+        }
+        return res;
+    }
+    
+    Element* find_i(LispE* lisp, u_ustring& w) {
+        vector<char> found;
+        candidates(w, found);
+        List* res = lisp->provideList();
+        Integers* positions;
+        long b, e;
+        for (long i = 0; i < found.size(); i++) {
+            if (found[i] && automatons[i]->search(w, b, e)) {
+                positions = lisp->provideIntegers();
+                positions->liste.push_back(i);
+                positions->liste.push_back(b);
+                positions->liste.push_back(e);
+                res->append(positions);
+            }
+        }
+        return res;
+    }
+    
+    Element* match(LispE* lisp, u_ustring& w) {
+        vector<char> found(automatons.size(), 0);
+        Integers* res = lisp->provideIntegers();
+        //An empty set has no starting state to match from
+        if (!automatons.size())
+            return res;
+        long i;
+        if (!matching->overflow) {
+            matching->lock.lock();
+            bool decided = matching->matches(w, found);
+            matching->lock.unlock();
+            if (decided) {
+                for (i = 0; i < found.size(); i++) {
+                    if (found[i])
+                        res->liste.push_back(i);
+                }
+                return res;
+            }
+        }
+        
+        for (i = 0; i < automatons.size(); i++) {
+            if (automatons[i]->match(w))
+                res->liste.push_back(i);
+        }
+        return res;
+    }
+    
+    long size() {
+        return automatons.size();
+    }
+    
+    wstring asString(LispE* lisp) {
+        u_ustring w = U"rgxset(";
+        for (long i = 0; i < patterns.size(); i++) {
+            if (i)
+                w += U" ";
+            w += U"\"";
+            w += patterns[i];
+            w += U"\"";
+        }
+        w += U")";
+        return _u_to_w(w);
+    }
+};
+
 #ifdef POSIXREGEX
 class LispEPosixRegularExpression : public Element {
 public:
@@ -1234,7 +1766,8 @@ public:
 };
 #endif
 
-typedef enum {rgx_rgx, rgx_find, rgx_findall, rgx_find_i, rgx_findall_i, rgx_split, rgx_match, rgx_replace
+typedef enum {rgx_rgx, rgx_find, rgx_findall, rgx_find_i, rgx_findall_i, rgx_split, rgx_match, rgx_replace,
+    rgx_set, rgx_set_find, rgx_set_find_i, rgx_set_match
 #ifdef POSIXREGEX
     , prgx_rgx, prgx_find, prgx_findall, prgx_find_i, prgx_findall_i, prgx_split, prgx_match, prgx_replace
 #endif
@@ -1244,6 +1777,7 @@ class RegularExpressionConstructor : public Element {
 public:
     rgx reg;
     short l_rgx;
+    short l_rgxset;
     
     RegularExpressionConstructor(LispE* lisp, rgx r) : reg(r), Element(l_lib, s_constant) {
         u_ustring wrgx = U"rgx_";
@@ -1252,6 +1786,8 @@ public:
             wrgx = U"prgx_";
 #endif
         l_rgx = lisp->encode(wrgx);
+        wrgx = U"rgxset_";
+        l_rgxset = lisp->encode(wrgx);
     }
     
     virtual Element* eval(LispE* lisp) {
@@ -1321,6 +1857,43 @@ public:
                 u_ustring value = lisp->get_variable(U"str")->asUString(lisp);
                 return ((LispERegularExpressions*)e)->split(lisp, value);
             }
+            case rgx_set: {
+                Element* e = lisp->get_variable(U"patterns");
+                if (!e->isList() && e->type != t_strings)
+                    throw new Error("Error: expecting a list of regular expressions");
+                LispERegularExpressionSet* set = new LispERegularExpressionSet(l_rgxset);
+                u_ustring w;
+                for (long i = 0; i < e->size(); i++) {
+                    w = e->index(i)->asUString(lisp);
+                    if (!set->add(w)) {
+                        delete set;
+                        throw new Error("Error: Unrecognized regular expression");
+                    }
+                }
+                set->compile();
+                return set;
+            }
+            case rgx_set_find: {
+                Element* e = lisp->get_variable(U"exp");
+                if (e->type != l_rgxset)
+                    throw new Error("Error: the first element must be a set of regular expressions");
+                u_ustring value = lisp->get_variable(U"str")->asUString(lisp);
+                return ((LispERegularExpressionSet*)e)->find(lisp, value);
+            }
+            case rgx_set_find_i: {
+                Element* e = lisp->get_variable(U"exp");
+                if (e->type != l_rgxset)
+                    throw new Error("Error: the first element must be a set of regular expressions");
+                u_ustring value = lisp->get_variable(U"str")->asUString(lisp);
+                return ((LispERegularExpressionSet*)e)->find_i(lisp, value);
+            }
+            case rgx_set_match: {
+                Element* e = lisp->get_variable(U"exp");
+                if (e->type != l_rgxset)
+                    throw new Error("Error: the first element must be a set of regular expressions");
+                u_ustring value = lisp->get_variable(U"str")->asUString(lisp);
+                return ((LispERegularExpressionSet*)e)->match(lisp, value);
+            }
 #ifdef POSIXREGEX
             case prgx_rgx: {
                 wstring expression = lisp->get_variable(U"exp")->asString(lisp);
@@ -1418,6 +1991,18 @@ public:
                 return L"Split 'str' via a regular expression";
                 break;
             }
+            case rgx_set: {
+                return L"Creates a set of regular expressions from a list of strings";
+            }
+            case rgx_set_find: {
+                return L"Returns the indexes of the regular expressions in 'exp' that match a sub-string of 'str'";
+            }
+            case rgx_set_find_i: {
+                return L"Returns for each regular expression in 'exp' that matches in 'str': (index start end)";
+            }
+            case rgx_set_match: {
+                return L"Returns the indexes of the regular expressions in 'exp' that match 'str'";
+            }
 #ifdef POSIXREGEX
             case prgx_rgx: {
                 return L"Creates a posix regular expression from a string";            }
@@ -1523,6 +2108,10 @@ void moduleRGX(LispE* lisp) {
     lisp->extension("deflib rgx_match (exp str)", new RegularExpressionConstructor(lisp, rgx_match));
     lisp->extension("deflib rgx_replace (exp str rep)", new RegularExpressionConstructor(lisp, rgx_replace));
     lisp->extension("deflib rgx_split (exp str)", new RegularExpressionConstructor(lisp, rgx_split));
+    lisp->extension("deflib rgxset (patterns)", new RegularExpressionConstructor(lisp, rgx_set));
+    lisp->extension("deflib rgxset_find (exp str)", new RegularExpressionConstructor(lisp, rgx_set_find));
+    lisp->extension("deflib rgxset_find_i (exp str)", new RegularExpressionConstructor(lisp, rgx_set_find_i));
+    lisp->extension("deflib rgxset_match (exp str)", new RegularExpressionConstructor(lisp, rgx_set_match));
 
 #ifdef POSIXREGEX
     lisp->extension("deflib prgx (exp (str))", new RegularExpressionPool(lisp, prgx_rgx));
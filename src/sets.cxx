@@ -15,6 +15,63 @@
 #include "avl.h"
 #include <math.h>
 #include <algorithm>
+#include <type_traits>
+
+//------------------------------------------------------------------------------------------
+// Set algebra between two sets of the same type
+//------------------------------------------------------------------------------------------
+// std::set is ordered, hence when both arguments share the same type, we can
+// merge them in one single pass instead of looking up each element in the other set.
+// Since the results are produced in increasing order, each insertion is done with
+// a hint at the end of the set, which costs amortized O(1).
+// When one set is much smaller than the other, we gallop over the larger one
+// with a lookup per element of the smaller one: O(small.log(large)).
+const long set_gallop_ratio = 32;
+
+template <class T> static void set_merge_and(std::set<T>& a, std::set<T>& b, std::set<T>& result) {
+    std::set<T>* small = &a;
+    std::set<T>* large = &b;
+    if (small->size() > large->size()) {
+        small = &b;
+        large = &a;
+    }
+    
+    if (small->empty())
+        return;
+    
+    if (large->size() / small->size() >= set_gallop_ratio) {
+        for (auto& e : *small) {
+            if (large->find(e) != large->end())
+                result.insert(result.end(), e);
+        }
+        return;
+    }
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(result, result.end()));
+}
+
+//When one set is much smaller, or when comparisons are cheap (numbers), copying the tree
+//of the larger set and inserting the elements of the smaller one is faster than rebuilding
+//the result element by element
+template <class T> static void set_merge_or(std::set<T>& a, std::set<T>& b, std::set<T>& result) {
+    std::set<T>* small = &a;
+    std::set<T>* large = &b;
+    if (small->size() > large->size()) {
+        small = &b;
+        large = &a;
+    }
+    
+    if (std::is_arithmetic<T>::value || small->empty() || large->size() / small->size() >= set_gallop_ratio) {
+        result = *large;
+        for (auto& e : *small)
+            result.insert(e);
+        return;
+    }
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::inserter(result, result.end()));
+}
+
+template <class T> static void set_merge_xor(std::set<T>& a, std::set<T>& b, std::set<T>& result) {
+    std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(result, result.end()));
+}
 
 Element* Set_s::duplicate_constant(LispE* lisp, bool pair) {
     if (status == s_constant) {
@@ -434,6 +491,11 @@ Element* Set_s::list_and(LispE* lisp, Element* value) {
         throw new Error("Error: Can only apply '&&&' to strings, lists or sets");
     
     Set_s* s = lisp->provideSet_s();
+    if (value->type == t_sets) {
+        set_merge_and(ensemble, ((Set_s*)value)->ensemble, s->ensemble);
+        return s;
+    }
+    
     for (auto& a: ensemble) {
         exchange_value.content = a;
         if (value->check_element(lisp, &exchange_value))
@@ -447,6 +509,11 @@ Element* Set_s::list_or(LispE* lisp, Element* value) {
         throw new Error("Error: Can only apply '|||' to strings, lists or sets");
     
     Set_s* s = lisp->provideSet_s();
+    if (value->type == t_sets) {
+        set_merge_or(ensemble, ((Set_s*)value)->ensemble, s->ensemble);
+        return s;
+    }
+    
     s->ensemble = ensemble;
     
     if (value->type == t_llist) {
@@ -483,6 +550,11 @@ Element* Set_s::list_xor(LispE* lisp, Element* value) {
         throw new Error("Error: Can only apply '^^^' to strings, lists or sets");
     
     Set_s* s = lisp->provideSet_s();
+    if (value->type == t_sets) {
+        set_merge_xor(ensemble, ((Set_s*)value)->ensemble, s->ensemble);
+        return s;
+    }
+    
     Set_s* intersection = (Set_s*)list_and(lisp, value);
     
     for (auto & a : ensemble) {
@@ -703,6 +775,11 @@ Element* Set_i::list_and(LispE* lisp, Element* value) {
         throw new Error("Error: Can only apply '&&&' to strings, lists or sets");
     
     Set_i* s = lisp->provideSet_i();
+    if (value->type == t_seti) {
+        set_merge_and(ensemble, ((Set_i*)value)->ensemble, s->ensemble);
+        return s;
+    }
+    
     for (auto& a: ensemble) {
         exchange_value.integer = a;
         if (value->check_element(lisp, &exchange_value))
@@ -716,6 +793,11 @@ Element* Set_i::list_or(LispE* lisp, Element* value) {
         throw new Error("Error: Can only apply '|||' to strings, lists or sets");
     
     Set_i* s = lisp->provideSet_i();
+    if (value->type == t_seti) {
+        set_merge_or(ensemble, ((Set_i*)value)->ensemble, s->ensemble);
+        return s;
+    }
+    
     s->ensemble = ensemble;
     
     if (value->type == t_llist) {
@@ -752,6 +834,11 @@ Element* Set_i::list_xor(LispE* lisp, Element* value) {
         throw new Error("Error: Can only apply '^^^' to strings, lists or sets");
     
     Set_i* s = lisp->provideSet_i();
+    if (value->type == t_seti) {
+        set_merge_xor(ensemble, ((Set_i*)value)->ensemble, s->ensemble);
+        return s;
+    }
+    
     Set_i* intersection = (Set_i*)list_and(lisp, value);
     
     for (auto & a : ensemble) {
@@ -1230,6 +1317,11 @@ Element* Set_n::list_and(LispE* lisp, Element* value) {
         throw new Error("Error: Can only apply '&&&' to strings, lists or sets");
     
     Set_n* s = lisp->provideSet_n();
+    if (value->type == t_setn) {
+        set_merge_and(ensemble, ((Set_n*)value)->ensemble, s->ensemble);
+        return s;
+    }
+    
     for (auto& a: ensemble) {
         exchange_value.number = a;
         if (value->check_element(lisp, &exchange_value))
@@ -1243,6 +1335,11 @@ Element* Set_n::list_or(LispE* lisp, Element* value) {
         throw new Error("Error: Can only apply '|||' to strings, lists or sets");
     
     Set_n* s = lisp->provideSet_n();
+    if (value->type == t_setn) {
+        set_merge_or(ensemble, ((Set_n*)value)->ensemble, s->ensemble);
+        return s;
+    }
+    
     s->ensemble = ensemble;
     
     if (value->type == t_llist) {
@@ -1279,6 +1376,11 @@ Element* Set_n::list_xor(LispE* lisp, Element* value) {
         throw new Error("Error: Can only apply '^^^' to strings, lists or sets");
     
     Set_n* s = lisp->provideSet_n();
+    if (value->type == t_setn) {
+        set_merge_xor(ensemble, ((Set_n*)value)->ensemble, s->ensemble);
+        return s;
+    }
+    
     Set_n* intersection = (Set_n*)list_and(lisp, value);
     
     for (auto & a : ensemble) {
@@ -1838,6 +1940,8 @@ void Setpool::decrement() {
         dictionary.clear();
         lisp->set_pool.push_back(this);
     }
+    else
+        lisp->cycle_candidate(this);
 }
 
 void Setpool::decrementstatus(uint16_t nb) {
@@ -1851,6 +1955,22 @@ void Setpool::decrementstatus(uint16_t nb) {
         dictionary.clear();
         lisp->set_pool.push_back(this);
     }
+    else
+        lisp->cycle_candidate(this);
+}
+
+//This set is only referenced through cycles (see LispE::collect_cycles)
+long Setpool::collect(std::unordered_map<Element*, long>& nodes) {
+    long bytes = sizeof(Setpool) + dictionary.size() * (sizeof(u_ustring) + sizeof(Element*));
+    for (auto& a : dictionary) {
+        auto it = nodes.find(a.second);
+        if (it == nodes.end() || it->second)
+            a.second->decrement();
+    }
+    status = 0;
+    dictionary.clear();
+    lisp->set_pool.push_back(this);
+    return bytes;
 }
 
 void Setpool::release() {
@@ -18,6 +18,8 @@
 #include "tools.h"
 #include "rgx.h"
 #include "tokens.h"
+#include <algorithm>
+#include <thread>
 //This extension is done in two steps
 
 #ifdef WIN32
@@ -66,9 +68,7 @@ char x_tokens::loop(u_ustring& toparse, short i, u_uchar* token, u_uchar* chr, l
             }
         }
         
-        u_ustring& label = rule[r];
-        
-        switch(check(label,type, chr)) {
+        switch(checkrule(i, r, chr)) {
             case 0:
                 if (!r && verif(type,xr_char))
                     return 2;
@@ -100,7 +100,7 @@ char x_tokens::loop(u_ustring& toparse, short i, u_uchar* token, u_uchar* chr, l
                 }
             }
 
-            short esc_char = check(label,type,chr);
+            short esc_char = checkrule(i, r, chr);
             
             while (esc_char) {
                 if (esc_char==2) {
@@ -109,7 +109,7 @@ char x_tokens::loop(u_ustring& toparse, short i, u_uchar* token, u_uchar* chr, l
                 }
                 else {
                     if (nxt) {
-                        if (check(rule[r + 1], element[r + 1], chr)) {
+                        if (checkrule(i, r + 1, chr)) {
                             if (nxt==1)
                                 break;
                             
@@ -118,7 +118,7 @@ char x_tokens::loop(u_ustring& toparse, short i, u_uchar* token, u_uchar* chr, l
                             getnext(toparse, cc, cp);
                             bool found = true;
                             for (short k = r+2; k < ni; k++) {
-                                if (!check(rule[k],element[k],cc)) {
+                                if (!checkrule(i, k, cc)) {
                                     found = false;
                                     break;
                                 }
@@ -133,7 +133,7 @@ char x_tokens::loop(u_ustring& toparse, short i, u_uchar* token, u_uchar* chr, l
                 
                 waddtoken(token,chr,itoken);
                 getnext(toparse,chr,posc,l);
-                esc_char = check(label,type,chr);
+                esc_char = checkrule(i, r, chr);
             }
         }
     }
@@ -187,7 +187,7 @@ void x_tokens::apply(u_ustring& toparse, vecte_n<u_ustring>* vstack) {
                     //if the rule only checks one character, and it is a direct check, we can stop there
                     ty = action[i];
                     if (ty != -1) {
-                        vstack->push_back(currentchr);
+                        stacking(vstack, currentchr);
                         stacktype.push_back(ty);
                         if (!juststack) {
                             stackln.push_back(line);
@@ -223,7 +223,7 @@ void x_tokens::apply(u_ustring& toparse, vecte_n<u_ustring>* vstack) {
 
             ty=action[i];
             if (ty != -1) {
-                vstack->push_back(token);
+                stacking(vstack, token);
                 stacktype.push_back(ty);
                 if (!juststack) {
                     stackln.push_back(line);
@@ -237,7 +237,7 @@ void x_tokens::apply(u_ustring& toparse, vecte_n<u_ustring>* vstack) {
         }
         
         if (!getit) { //Character not taken into account by a rule, we suppose it is a simple UTF8 character...
-            vstack->push_back(currentchr);
+            stacking(vstack, currentchr);
             stacktype.push_back(0);
             stackln.push_back(line);
             getnext(toparse,currentchr, pos,l);
@@ -246,11 +246,158 @@ void x_tokens::apply(u_ustring& toparse, vecte_n<u_ustring>* vstack) {
     delete[] token;
 }
 
-typedef enum {str_lowercase, str_uppercase, str_is_vowel, str_is_consonant, str_deaccentuate, str_is_emoji, str_emoji_description, str_is_lowercase, str_is_uppercase, str_is_alpha, str_remplace, str_left, str_right, str_middle, str_trim, str_trim0, str_trimleft, str_trimright, str_base,
+//------------------------------------------------------------------------
+//Levenshtein distance with the bit-parallel algorithm of Myers, in the block version of Hyyrö
+//The pattern is split into blocks of 64 characters. For each character, peq stores a bit vector
+//of the positions where it occurs in the pattern...
+//Above edit_threading strings, the batch version is split across threads
+const long edit_threading = 1 << 10;
+
+class edit_pattern {
+public:
+    u_ustring pattern;
+    unordered_map<u_uchar, uint64_t*> peq_unicode;
+    uint64_t* peq_ascii[128];
+    uint64_t* zeros;
+    uint64_t lastbit;
+    long nbblocks;
+    long size;
+
+    edit_pattern(u_ustring& p) : pattern(p) {
+        size = p.size();
+        nbblocks = (size + 63) >> 6;
+        lastbit = (uint64_t)1 << ((size - 1) & 63);
+        zeros = new uint64_t[nbblocks + 1];
+        memset(zeros, 0, (nbblocks + 1) * sizeof(uint64_t));
+        long i;
+        for (i = 0; i < 128; i++)
+            peq_ascii[i] = zeros;
+        
+        uint64_t* v;
+        u_uchar c;
+        for (i = 0; i < size; i++) {
+            c = p[i];
+            v = peq(c);
+            if (v == zeros) {
+                v = new uint64_t[nbblocks];
+                memset(v, 0, nbblocks * sizeof(uint64_t));
+                if (c < 128)
+                    peq_ascii[c] = v;
+                else
+                    peq_unicode[c] = v;
+            }
+            v[i >> 6] |= (uint64_t)1 << (i & 63);
+        }
+    }
+    
+    ~edit_pattern() {
+        for (long i = 0; i < 128; i++) {
+            if (peq_ascii[i] != zeros)
+                delete[] peq_ascii[i];
+        }
+        for (auto& a : peq_unicode)
+            delete[] a.second;
+        delete[] zeros;
+    }
+    
+    inline uint64_t* peq(u_uchar c) {
+        if (c < 128)
+            return peq_ascii[c];
+        auto it = peq_unicode.find(c);
+        return (it == peq_unicode.end())?zeros:it->second;
+    }
+    
+    //Returns the distance between the pattern and text
+    //If this distance is larger than bound, the computation stops and returns bound + 1
+    long distance(u_ustring& text, long bound) {
+        long n = text.size();
+        if (!size)
+            return n;
+        
+        long b;
+        long score = size;
+        uint64_t* pv = new uint64_t[nbblocks];
+        uint64_t* mv = new uint64_t[nbblocks];
+        for (b = 0; b < nbblocks; b++) {
+            pv[b] = ~(uint64_t)0;
+            mv[b] = 0;
+        }
+        
+        uint64_t* eqs;
+        uint64_t eq, xv, xh, ph, mh, hin_neg, high;
+        int hin, hout;
+        for (long j = 0; j < n; j++) {
+            eqs = peq(text[j]);
+            //The first row of the matrix is 0,1,2...n, hence a +1 on the first block
+            hin = 1;
+            for (b = 0; b < nbblocks; b++) {
+                high = (b == nbblocks - 1)?lastbit:(uint64_t)1 << 63;
+                hin_neg = (hin < 0);
+                eq = eqs[b];
+                xv = eq | mv[b];
+                eq |= hin_neg;
+                xh = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+                ph = mv[b] | ~(xh | pv[b]);
+                mh = pv[b] & xh;
+                hout = 0;
+                if (ph & high)
+                    hout = 1;
+                else
+                    if (mh & high)
+                        hout = -1;
+                ph <<= 1;
+                mh <<= 1;
+                mh |= hin_neg;
+                ph |= (uint64_t)(hin > 0);
+                pv[b] = mh | ~(xv | ph);
+                mv[b] = ph & xv;
+                hin = hout;
+            }
+            score += hout;
+            //each remaining character can only decrease the score by 1
+            if (score - (n - j - 1) > bound) {
+                score = bound + 1;
+                break;
+            }
+        }
+        delete[] pv;
+        delete[] mv;
+        return score;
+    }
+};
+
+//The best k strings in strs[first..last[ within bound of p
+static void edit_best(edit_pattern* p, vecte_n<u_ustring>* strs, long first, long last, long k, long bound, vector<std::pair<long, long> >* best) {
+    long d, sz;
+    best->clear();
+    for (long i = first; i < last; i++) {
+        sz = (*strs)[i].size();
+        //length filtering: the distance is at least the difference of sizes
+        if (sz - p->size > bound || p->size - sz > bound)
+            continue;
+        d = p->distance((*strs)[i], bound);
+        if (d > bound)
+            continue;
+        //best is kept sorted on distance then position
+        std::pair<long, long> e(d, i);
+        best->insert(std::upper_bound(best->begin(), best->end(), e), e);
+        if (best->size() > k)
+            best->pop_back();
+        //we only keep strings that improve on our current k best
+        if (best->size() == k) {
+            bound = best->back().first - 1;
+            if (bound < 0)
+                break;
+        }
+    }
+}
+
+typedef enum {str_lowercase, str_uppercase, str_lowercase_all, str_uppercase_all, str_deaccentuate_all, str_is_vowel, str_is_consonant, str_deaccentuate, str_is_emoji, str_emoji_description, str_is_lowercase, str_is_uppercase, str_is_alpha, str_remplace, str_left, str_right, str_middle, str_trim, str_trim0, str_trimleft, str_trimright, str_base,
     str_tokenize_lispe, str_tokenize_empty, str_split, str_split_empty, str_ord, str_chr, str_is_punctuation,
     str_format, str_padding, str_fill, str_getstruct,
-    str_edit_distance, str_read_json, str_parse_json, str_string_json, str_ngrams,
-    str_rules,str_tokenize_rules, str_getrules, str_setrules} string_method;
+    str_edit_distance, str_edit_distance_best, str_read_json, str_parse_json, str_string_json, str_ngrams,
+    str_ngram_counter, str_ngram_add, str_ngram_add_file, str_ngram_frequency, str_ngram_counts,
+    str_rules,str_tokenize_rules, str_tokenize_rules_all, str_getrules, str_setrules} string_method;
 
 /*
  First of all we create a new Element derivation
@@ -271,6 +418,183 @@ public:
     }
 };
 
+//------------------------------------------------------------------------
+//Counting ngrams without building them: each ngram is reduced to a rolling hash over its characters
+//(or over the hashes of its words), which is either recorded in a map or in a count-min sketch.
+//In the map, the ngram string is only stored for its first occurrence.
+//Two ngrams sharing the same 64 bits hash are counted together.
+const uint64_t ngram_base = 1099511628211ULL;
+//Upper bounds on the ngram size and on the number of cells of a count-min sketch
+const long ngram_max_size = 1L << 20;
+const long ngram_max_cells = 1L << 28;
+
+static inline uint64_t ngram_mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+class ngram_entry {
+public:
+    u_ustring label;
+    long count;
+    
+    ngram_entry() : count(0) {}
+};
+
+class Ngramcounter : public Element {
+public:
+    unordered_map<uint64_t, ngram_entry> counts;
+    vector<long> sketch;
+    vector<uint64_t> whash;
+    vector<long> wbegin;
+    vector<long> wend;
+    uint64_t power;
+    long nb;
+    long width;
+    long depth;
+    bool words;
+    
+    Ngramcounter(short l_ngrams, long n, bool w, long wd, long dp) : Element(l_ngrams) {
+        nb = n;
+        words = w;
+        width = wd;
+        depth = dp;
+        //power is base^(nb-1), to remove the first element from the rolling hash
+        power = 1;
+        for (long i = 1; i < nb; i++)
+            power *= ngram_base;
+        if (width)
+            sketch.resize(width * depth, 0);
+        if (words) {
+            whash.resize(nb, 0);
+            wbegin.resize(nb, 0);
+            wend.resize(nb, 0);
+        }
+    }
+    
+    wstring asString(LispE* lisp) {
+        return L"ngrams";
+    }
+    
+    //The depth hash functions of the sketch are derived from h (Kirsch-Mitzenmacher)
+    inline long cell(uint64_t h, long i) {
+        return i * width + (long)(((h & 0xFFFFFFFF) + i * ((h >> 32) | 1)) % width);
+    }
+    
+    inline ngram_entry* add(uint64_t h) {
+        if (width) {
+            for (long i = 0; i < depth; i++)
+                sketch[cell(h, i)]++;
+            return NULL;
+        }
+        ngram_entry& e = counts[h];
+        //the label is only needed for a new ngram
+        return (e.count++)?NULL:&e;
+    }
+    
+    long frequency(uint64_t h) {
+        if (width) {
+            long m = sketch[cell(h, 0)];
+            for (long i = 1; i < depth; i++)
+                m = std::min(m, sketch[cell(h, i)]);
+            return m;
+        }
+        auto it = counts.find(h);
+        return (it == counts.end())?0:it->second.count;
+    }
+    
+    //the hash of the nb first characters of s
+    uint64_t hash_characters(u_ustring& s) {
+        uint64_t h = 0;
+        for (long i = 0; i < nb; i++)
+            h = h * ngram_base + ngram_mix(s[i]);
+        return h;
+    }
+    
+    void count_characters(u_ustring& s) {
+        long sz = s.size();
+        if (sz < nb)
+            return;
+        
+        uint64_t h = hash_characters(s);
+        ngram_entry* e = add(h);
+        if (e != NULL)
+            e->label = s.substr(0, nb);
+        for (long i = nb; i < sz; i++) {
+            h = (h - ngram_mix(s[i - nb]) * power) * ngram_base + ngram_mix(s[i]);
+            e = add(h);
+            if (e != NULL)
+                e->label = s.substr(i - nb + 1, nb);
+        }
+    }
+    
+    //Words are separated with spaces (code <= 32).
+    //Returns the number of words read, h is the hash of the last nb words
+    long scan_words(u_ustring& s, uint64_t& h, bool counting) {
+        long sz = s.size();
+        long i = 0, b, k = 0, slot;
+        uint64_t w;
+        h = 0;
+        while (i < sz) {
+            while (i < sz && s[i] <= 32)
+                i++;
+            if (i == sz)
+                break;
+            b = i;
+            w = 0;
+            while (i < sz && s[i] > 32)
+                w = w * ngram_base + ngram_mix(s[i++]);
+            w = ngram_mix(w);
+            
+            slot = k % nb;
+            if (k >= nb)
+                h -= whash[slot] * power;
+            h = h * ngram_base + w;
+            whash[slot] = w;
+            wbegin[slot] = b;
+            wend[slot] = i;
+            k++;
+            
+            if (counting && k >= nb) {
+                ngram_entry* e = add(h);
+                if (e != NULL) {
+                    //the words are joined with a single space
+                    for (long j = k - nb; j < k; j++) {
+                        slot = j % nb;
+                        if (j != k - nb)
+                            e->label += U" ";
+                        e->label += s.substr(wbegin[slot], wend[slot] - wbegin[slot]);
+                    }
+                }
+            }
+        }
+        return k;
+    }
+    
+    void counting(u_ustring& s) {
+        if (words) {
+            uint64_t h;
+            scan_words(s, h, true);
+        }
+        else
+            count_characters(s);
+    }
+    
+    long frequency(u_ustring& s) {
+        if (words) {
+            uint64_t h;
+            if (scan_words(s, h, false) != nb)
+                return 0;
+            return frequency(h);
+        }
+        if (s.size() != nb)
+            return 0;
+        return frequency(hash_characters(s));
+    }
+};
+
 class Stringmethod : public Element {
 public:
     string_method met;
@@ -280,6 +604,7 @@ public:
     short v_nb;
     short v_pos;
     short l_tokenize;
+    short l_ngrams;
     
     Stringmethod(LispE* lisp, string_method s) : met(s), Element(l_lib) {
         //We know the names of variables in advance, so we might as well take advantage of it to retrieve their codes.
@@ -295,6 +620,8 @@ public:
         v_pos = lisp->encode(nom);
         nom = U"tokenize_rule";
         l_tokenize = lisp->encode(nom);
+        nom = U"ngram_counter";
+        l_ngrams = lisp->encode(nom);
     }
     
     Element* parse_json(LispE* lisp, u_ustring& w) {
@@ -503,31 +830,79 @@ public:
         return lisp->provideInteger(v);
     }
     
-    #define MIN3(a, b, c) ((a) < (b) ? ((a) < (c) ? (a) : (c)) : ((b) < (c) ? (b) : (c)))
-
     Element* methodEditDistance(LispE* lisp) {
         u_ustring s1 = lisp->get_variable(v_str)->asUString(lisp);
         u_ustring s2 = lisp->get_variable("strbis")->asUString(lisp);
+        //the shortest string is used as pattern
+        if (s1.size() > s2.size())
+            s1.swap(s2);
+        edit_pattern p(s1);
+        return lisp->provideInteger(p.distance(s2, s2.size()));
+    }
+
+    Element* methodEditDistanceBest(LispE* lisp) {
+        u_ustring s = lisp->get_variable(v_str)->asUString(lisp);
+        Element* lst = lisp->get_variable(U"strs");
+        if (!lst->isList())
+            throw new Error("Error: the second argument should be a list of strings");
+        long k = lisp->get_variable(v_nb)->asInteger();
+        long bound = lisp->get_variable(U"bound")->asInteger();
         
-        unsigned long s1len, s2len, x, y, lastdiag, olddiag;
-        s1len = s1.size();
-        s2len = s2.size();
-        size_t* column = new size_t[s1len + 1];
-        for (y = 1; y <= s1len; y++)
-            column[y] = y;
-        for (x = 1; x <= s2len; x++) {
-            column[0] = x;
-            for (y = 1, lastdiag = x - 1; y <= s1len; y++) {
-                olddiag = column[y];
-                column[y] = MIN3(column[y] + 1, column[y - 1] + 1, lastdiag + (s1[y - 1] == s2[x - 1] ? 0 : 1));
-                lastdiag = olddiag;
-            }
+        Strings* found = lisp->provideStrings();
+        Integers* distances = lisp->provideIntegers();
+        List* result = lisp->provideList();
+        result->append(found);
+        result->append(distances);
+        if (k <= 0)
+            return result;
+        
+        vecte_n<u_ustring> local;
+        vecte_n<u_ustring>* strs = &local;
+        long i, sz = lst->size();
+        if (lst->type == t_strings)
+            strs = &((Strings*)lst)->liste;
+        else {
+            for (i = 0; i < sz; i++)
+                local.push_back(lst->index(i)->asUString(lisp));
+        }
+        
+        edit_pattern p(s);
+        //no bound: the distance cannot be larger than the longest string
+        if (bound < 0) {
+            bound = p.size;
+            for (i = 0; i < sz; i++)
+                bound = std::max(bound, (long)(*strs)[i].size());
+        }
+        
+        vector<std::pair<long, long> > best;
+        long nbthreads = std::thread::hardware_concurrency();
+        if (nbthreads <= 1 || sz < edit_threading)
+            edit_best(&p, strs, 0, sz, k, bound, &best);
+        else {
+            //Each thread keeps its own k best, which are then merged
+            vector<vector<std::pair<long, long> > > results(nbthreads);
+            vecte<std::thread*> threads;
+            long slice = (sz + nbthreads - 1) / nbthreads;
+            long t = 0;
+            for (i = 0; i < sz; i += slice, t++)
+                threads.push_back(new std::thread(edit_best, &p, strs, i, std::min(i + slice, sz), k, bound, &results[t]));
+            for (i = 0; i < threads.size(); i++) {
+                threads[i]->join();
+                delete threads[i];
+            }
+            for (i = 0; i < t; i++)
+                best.insert(best.end(), results[i].begin(), results[i].end());
+            std::sort(best.begin(), best.end());
+            if (best.size() > k)
+                best.resize(k);
+        }
+        
+        for (i = 0; i < best.size(); i++) {
+            found->liste.push_back((*strs)[best[i].second]);
+            distances->liste.push_back(best[i].first);
         }
-        s2len = column[s1len];
-        delete[] column;
-        return lisp->provideInteger(s2len);
+        return result;
     }
-
     
     Element* eval(LispE* lisp) {
         //eval is either: command, setenv or getenv...
@@ -578,6 +953,35 @@ public:
                 s = lisp->handlingutf8->u_to_upper(s);
                 return lisp->provideString(s);
             }
+            case str_lowercase_all:
+            case str_uppercase_all:
+            case str_deaccentuate_all: {
+                //The whole list is converted into a Strings
+                Element* strs = lisp->get_variable(U"strs");
+                if (!strs->isList())
+                    throw new Error("Error: this function expects a list of strings");
+                Chaine_UTF8* utf8 = lisp->handlingutf8;
+                Strings* result = lisp->provideStrings();
+                long sz = strs->size();
+                u_ustring s;
+                for (long i = 0; i < sz; i++) {
+                    if (strs->type == t_strings)
+                        s = ((Strings*)strs)->liste[i];
+                    else
+                        s = strs->index(i)->asUString(lisp);
+                    switch (met) {
+                        case str_lowercase_all:
+                            result->liste.push_back(utf8->u_to_lower(s));
+                            break;
+                        case str_uppercase_all:
+                            result->liste.push_back(utf8->u_to_upper(s));
+                            break;
+                        default:
+                            result->liste.push_back(utf8->s_deaccentuate(s));
+                    }
+                }
+                return result;
+            }
             case str_is_emoji: {
                 u_ustring s =  lisp->get_variable(v_str)->asUString(lisp);
                 return booleans_[lisp->handlingutf8->u_is_emoji(s)];
@@ -632,6 +1036,89 @@ public:
                 }
                 return ke;
             }
+            case str_ngram_counter: {
+                long nb = lisp->get_variable(v_nb)->asInteger();
+                if (nb <= 0)
+                    throw new Error("Error: nb should be a positive value");
+                if (nb > ngram_max_size)
+                    throw new Error("Error: nb is too large");
+                bool words = lisp->get_variable(U"words")->Boolean();
+                long width = lisp->get_variable(U"width")->asInteger();
+                long depth = lisp->get_variable(U"depth")->asInteger();
+                if (width < 0 || (width && depth <= 0))
+                    throw new Error("Error: a count-min sketch needs a positive width and depth");
+                //width * depth is checked without computing it, to avoid any overflow
+                if (width && (depth > ngram_max_cells || width > ngram_max_cells / depth))
+                    throw new Error("Error: the count-min sketch is too large (width * depth)");
+                return new Ngramcounter(l_ngrams, nb, words, width, depth);
+            }
+            case str_ngram_add: {
+                Element* counter = lisp->get_variable(U"counter");
+                if (counter->type != l_ngrams)
+                    throw new Error("Error: the first element should be an ngram_counter object");
+                Ngramcounter* ngrams = (Ngramcounter*)counter;
+                Element* strs = lisp->get_variable(U"strs");
+                if (strs->type == t_strings) {
+                    vecte_n<u_ustring>& liste = ((Strings*)strs)->liste;
+                    for (long i = 0; i < liste.size(); i++)
+                        ngrams->counting(liste[i]);
+                }
+                else {
+                    u_ustring s;
+                    if (strs->isList()) {
+                        for (long i = 0; i < strs->size(); i++) {
+                            s = strs->index(i)->asUString(lisp);
+                            ngrams->counting(s);
+                        }
+                    }
+                    else {
+                        s = strs->asUString(lisp);
+                        ngrams->counting(s);
+                    }
+                }
+                return counter;
+            }
+            case str_ngram_add_file: {
+                Element* counter = lisp->get_variable(U"counter");
+                if (counter->type != l_ngrams)
+                    throw new Error("Error: the first element should be an ngram_counter object");
+                Ngramcounter* ngrams = (Ngramcounter*)counter;
+                string pathname = lisp->get_variable(U"pathname")->toString(lisp);
+                std::ifstream f(pathname.c_str(), std::ios::in|std::ios::binary);
+                if (f.fail())
+                    throw new Error("Error: cannot open file: " + pathname);
+                //The file is read line by line, ngrams do not cross lines
+                string line;
+                u_ustring s;
+                while (getline(f, line)) {
+                    s.clear();
+                    s_utf8_to_unicode(s, USTR(line), line.size());
+                    ngrams->counting(s);
+                }
+                return counter;
+            }
+            case str_ngram_frequency: {
+                Element* counter = lisp->get_variable(U"counter");
+                if (counter->type != l_ngrams)
+                    throw new Error("Error: the first element should be an ngram_counter object");
+                u_ustring s = lisp->get_variable(U"ngram")->asUString(lisp);
+                return lisp->provideInteger(((Ngramcounter*)counter)->frequency(s));
+            }
+            case str_ngram_counts: {
+                Element* counter = lisp->get_variable(U"counter");
+                if (counter->type != l_ngrams)
+                    throw new Error("Error: the first element should be an ngram_counter object");
+                Ngramcounter* ngrams = (Ngramcounter*)counter;
+                if (ngrams->width)
+                    throw new Error("Error: a count-min sketch does not keep its ngrams");
+                long threshold = lisp->get_variable(U"threshold")->asInteger();
+                Dictionary* d = lisp->provideDictionary();
+                for (auto& a : ngrams->counts) {
+                    if (a.second.count >= threshold)
+                        d->recording(a.second.label, lisp->provideInteger(a.second.count));
+                }
+                return d;
+            }
             case str_trim0: {
                 u_ustring strvalue =  lisp->get_variable(v_str)->asUString(lisp);
                 strvalue = u_trim0(strvalue);
@@ -704,7 +1191,7 @@ public:
 
                 size_t found = 0;
                 while (pos != string::npos) {
-                    found = strvalue.find(search_string, pos);
+                    found = ::u_find(strvalue, search_string, pos);
                     if (found != string::npos) {
                         localvalue = strvalue.substr(pos, found - pos);
                         result->append(localvalue);
@@ -764,7 +1251,7 @@ public:
 
                 size_t found = 0;
                 while (pos != string::npos) {
-                    found = strvalue.find(search_string, pos);
+                    found = ::u_find(strvalue, search_string, pos);
                     if (found != string::npos) {
                         localvalue = strvalue.substr(pos, found - pos);
                         if (localvalue != U"") {
@@ -849,6 +1336,43 @@ public:
                 }
                 return vstr;
             }
+            case str_tokenize_rules_all: {
+                //All tokens are packed into one single string: token k is the substring
+                //between ends[k-1] (or 0) and ends[k] and offsets[i] is the index of the first token of the ith string
+                Element* tok = lisp->get_variable(U"rules");
+                if (tok->type != l_tokenize)
+                    throw new Error("Error: the first element should be a string_rule object");
+                Element* strs = lisp->get_variable(U"strs");
+                if (!strs->isList())
+                    throw new Error("Error: the second element should be a list of strings");
+                Element* types = lisp->get_variable(U"types");
+                x_tokens& xtok = ((Rulemethod*)tok)->tok;
+                u_ustring buffer;
+                Integers* ends = lisp->provideIntegers();
+                Integers* offsets = lisp->provideIntegers();
+                Integers* t_ypes = NULL;
+                if (types != null_)
+                    t_ypes = lisp->provideIntegers();
+                u_ustring s;
+                long i, j;
+                for (i = 0; i < strs->size(); i++) {
+                    offsets->liste.push_back(ends->size());
+                    s = strs->index(i)->asUString(lisp);
+                    xtok.tokenize(s, buffer, ends->liste);
+                    if (t_ypes != NULL) {
+                        for (j = 0; j < xtok.stacktype.size(); j++)
+                            t_ypes->liste.push_back(xtok.stacktype[j]);
+                    }
+                }
+                offsets->liste.push_back(ends->size());
+                List* l = lisp->provideList();
+                l->append(lisp->provideString(buffer));
+                l->append(ends);
+                l->append(offsets);
+                if (t_ypes != NULL)
+                    l->append(t_ypes);
+                return l;
+            }
             case str_getrules: {
                 Element* tok = lisp->get_variable(U"rules");
                 if (tok->type != l_tokenize)
@@ -883,6 +1407,9 @@ public:
             case str_edit_distance: {
                 return methodEditDistance(lisp);
             }
+            case str_edit_distance_best: {
+                return methodEditDistanceBest(lisp);
+            }
             case str_base: {
                 return methodBase(lisp);
             }
@@ -907,6 +1434,12 @@ public:
             case str_uppercase: {
                 return L"Put in uppercase";
             }
+            case str_lowercase_all:
+                return L"Put each string of a list in lower case";
+            case str_uppercase_all:
+                return L"Put each string of a list in uppercase";
+            case str_deaccentuate_all:
+                return L"Remove the accents from letters in each string of a list";
             case str_is_lowercase: {
                 return L"Checks if the string is only lowercase";
             }
@@ -954,6 +1487,16 @@ public:
             }
             case str_ngrams:
                 return L"Builds a list of ngrams of size nb";
+            case str_ngram_counter:
+                return L"(ngram_counter nb (words false) (width 0) (depth 4)): creates an ngram counter, on characters or words. With a width, counts are kept in a count-min sketch";
+            case str_ngram_add:
+                return L"(ngram_add counter strs): counts the ngrams of a string or of a list of strings";
+            case str_ngram_add_file:
+                return L"(ngram_add_file counter pathname): counts the ngrams of each line of a file";
+            case str_ngram_frequency:
+                return L"(ngram_frequency counter ngram): returns the number of occurrences of ngram";
+            case str_ngram_counts:
+                return L"(ngram_counts counter (threshold 1)): returns a dictionary of the ngrams occurring at least threshold times";
             case str_read_json:
                 return L"Reads a JSON file";
             case str_parse_json:
@@ -972,6 +1515,8 @@ public:
                 return L"Tokenize a string into a list of tokens with LispE tokenize. Keep also the blanks";
             case str_tokenize_rules:
                 return L"Tokenize a string into a list of tokens with internal rules";
+            case str_tokenize_rules_all:
+                return L"Tokenize a list of strings with internal rules into one packed string, the end of each token in it and the offsets of each string";
             case str_getrules:
                 return L"Return the internal tokenization rules";
             case str_setrules:
@@ -986,6 +1531,8 @@ public:
                 return L"(fill c nb): creates a string made of nb 'c' characters";
             case str_edit_distance:
                 return L"(editdistance str strbis): compute the Levenshtein distance between str and strbis";
+            case str_edit_distance_best:
+                return L"(editdistance_best str strs (nb 1) (bound -1)): return the nb closest strings to str in strs within bound, with their distances";
             case str_base:
                 return L"(convert_in_base str b (convert_from): convert str into b or from base b according to convert_from";
             case str_getstruct:
@@ -1006,6 +1553,9 @@ void moduleChaines(LispE* lisp) {
     lisp->extension("deflib lower (str)", new Stringmethod(lisp, str_lowercase));
     lisp->extension("deflib format (str n1 (n2) (n3) (n4) (n5) (n6) (n7) (n8) (n9))", new Stringmethod(lisp, str_format));
     lisp->extension("deflib upper (str)", new Stringmethod(lisp, str_uppercase));
+    lisp->extension("deflib lower_all (strs)", new Stringmethod(lisp, str_lowercase_all));
+    lisp->extension("deflib upper_all (strs)", new Stringmethod(lisp, str_uppercase_all));
+    lisp->extension("deflib deaccentuate_all (strs)", new Stringmethod(lisp, str_deaccentuate_all));
     lisp->extension("deflib lowerp (str)", new Stringmethod(lisp, str_is_lowercase));
     lisp->extension("deflib upperp (str)", new Stringmethod(lisp, str_is_uppercase));
     lisp->extension("deflib alphap (str)", new Stringmethod(lisp, str_is_alpha));
@@ -1016,6 +1566,11 @@ void moduleChaines(LispE* lisp) {
     lisp->extension("deflib convert_in_base (str b (convert))", new Stringmethod(lisp, str_base));
     lisp->extension("deflib left (str nb)", new Stringmethod(lisp, str_left));
     lisp->extension("deflib ngrams (str nb)", new Stringmethod(lisp, str_ngrams));
+    lisp->extension("deflib ngram_counter (nb (words false) (width 0) (depth 4))", new Stringmethod(lisp, str_ngram_counter));
+    lisp->extension("deflib ngram_add (counter strs)", new Stringmethod(lisp, str_ngram_add));
+    lisp->extension("deflib ngram_add_file (counter pathname)", new Stringmethod(lisp, str_ngram_add_file));
+    lisp->extension("deflib ngram_frequency (counter ngram)", new Stringmethod(lisp, str_ngram_frequency));
+    lisp->extension("deflib ngram_counts (counter (threshold 1))", new Stringmethod(lisp, str_ngram_counts));
     lisp->extension("deflib right (str nb)", new Stringmethod(lisp, str_right));
     lisp->extension("deflib middle (str pos nb)", new Stringmethod(lisp, str_middle));
     lisp->extension("deflib getstruct (str open close (pos 0))", new Stringmethod(lisp, str_getstruct));
@@ -1028,11 +1583,13 @@ void moduleChaines(LispE* lisp) {
     lisp->extension("deflib padding (str c nb)", new Stringmethod(lisp, str_padding));
     lisp->extension("deflib fill (str nb)", new Stringmethod(lisp, str_fill));
     lisp->extension("deflib editdistance (str strbis)", new Stringmethod(lisp, str_edit_distance));
+    lisp->extension("deflib editdistance_best (str strs (nb 1) (bound -1))", new Stringmethod(lisp, str_edit_distance_best));
     lisp->extension("deflib vowelp (str)", new Stringmethod(lisp, str_is_vowel));
     lisp->extension("deflib consonantp (str)", new Stringmethod(lisp, str_is_consonant));
     lisp->extension("deflib deaccentuate (str)", new Stringmethod(lisp, str_deaccentuate));
     lisp->extension("deflib tokenizer_rules ()", new Stringmethod(lisp, str_rules));
     lisp->extension("deflib tokenize_rules (rules str (types))", new Stringmethod(lisp, str_tokenize_rules));
+    lisp->extension("deflib tokenize_rules_all (rules strs (types))", new Stringmethod(lisp, str_tokenize_rules_all));
     lisp->extension("deflib get_tokenizer_rules (rules)", new Stringmethod(lisp, str_getrules));
     lisp->extension("deflib set_tokenizer_rules (rules lst)", new Stringmethod(lisp, str_setrules));
 
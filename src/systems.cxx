@@ -35,6 +35,8 @@
 
 typedef enum {sys_command, sys_ls, sys_setenv, sys_getenv, sys_isdirectory, sys_fileinfo, sys_realpath} systeme;
 typedef enum {file_open, file_close, file_eof, file_read, file_readline, file_readlist, file_getchar, file_write, file_writeln, file_seek, file_tell, file_getstruct} file_command;
+typedef enum {pools_size, pools_trim, pools_maxsize, cycles_statistics, cycles_threshold} pools_command;
+typedef enum {pqueue_create, pqueue_push, pqueue_extend, pqueue_top, pqueue_pop, pqueue_update, pqueue_remove, pqueue_size} pqueue_command;
 typedef enum {date_setdate, date_year, date_month, date_day, date_hour, date_minute, date_second, date_yearday, date_raw, date_weekday } tempus;
 
 /*
@@ -1151,6 +1153,508 @@ public:
 };
 
 
+//Memory handling of the internal pools of elements
+class Pools : public Element {
+public:
+    pools_command action;
+    short v_nb;
+    short v_pool;
+    
+    Pools(LispE* lisp, pools_command a) : action(a), Element(l_lib) {
+        u_ustring nom = U"nb";
+        v_nb = lisp->encode(nom);
+        nom = U"pool";
+        v_pool = lisp->encode(nom);
+    }
+    
+    Element* eval(LispE* lisp) {
+        switch (action) {
+            case pools_size:
+                return lisp->pool_sizes();
+            case pools_trim: {
+                //We keep at most nb elements in each pool
+                long nb = lisp->get_variable(v_nb)->asInteger();
+                if (nb < 0)
+                    throw new Error("Error: the number of elements to keep cannot be negative");
+                Dictionary* d = lisp->provideDictionary();
+                lisp->trim_pools(nb, d);
+                return d;
+            }
+            case pools_maxsize: {
+                //-2 is the default value: we only return the current limit
+                long nb = lisp->get_variable(v_nb)->asInteger();
+                u_ustring pool = lisp->get_variable(v_pool)->asUString(lisp);
+                if (pool == U"") {
+                    long previous = lisp->pool_size_max();
+                    if (nb != -2)
+                        lisp->set_pool_max_size(nb);
+                    return lisp->provideInteger(previous);
+                }
+                
+                //The names are the keys of pools_size
+                Element* sizes = lisp->pool_sizes();
+                bool found = (((Dictionary*)sizes)->dictionary.find(pool) != ((Dictionary*)sizes)->dictionary.end());
+                sizes->release();
+                if (!found)
+                    throw new Error("Error: unknown pool");
+                long previous = lisp->pool_size_max(pool);
+                if (nb != -2)
+                    lisp->set_pool_max_size(nb, pool);
+                return lisp->provideInteger(previous);
+            }
+            case cycles_statistics:
+                return lisp->cycle_statistics();
+            case cycles_threshold: {
+                //-2 is the default value: we only return the current threshold
+                long nb = lisp->get_variable(v_nb)->asInteger();
+                long previous = lisp->cycle_collection_threshold();
+                if (nb != -2)
+                    lisp->set_cycle_collection_threshold(nb);
+                return lisp->provideInteger(previous);
+            }
+        }
+        return null_;
+    }
+    
+    wstring asString(LispE* lisp) {
+        switch (action) {
+            case pools_size:
+                return L"Returns the number of elements kept in each internal pool";
+            case pools_trim:
+                return L"Deletes the pooled elements beyond 'nb' in each pool, returns the number of deleted elements for each pool";
+            case pools_maxsize:
+                return L"Sets the number of elements kept in each pool after each execution (-1 for no limit), returns the previous value. With 'pool' (a name returned by pools_size), the limit only applies to this pool and replaces the general one";
+            case cycles_statistics:
+                return L"Returns the statistics of the cycle collections that took place at the end of the executions. Cycles through lists, dictionaries, sets and linked lists are collected, but not a cycle made of linked lists only";
+            case cycles_threshold:
+                return L"Enables the cycle collection when 'nb' >= 0 (number of candidates triggering a collection after each execution), -1 disables it, returns the previous value";
+        }
+        return L"";
+    }
+};
+
+//------------------------------------------------------------------------------------------
+//Priority queues as an implicit d-ary heap stored in an array
+//Each push returns a handle, which can be used to change the priority of a value or to remove it
+//With no comparator or with '<' and '>', priorities are numbers compared natively
+//Otherwise, priorities are compared with the comparator: (comparator p1 p2) is true if p1 comes first
+//The 'heap' instruction (an AVL tree) is still the container to use for ordered traversals
+typedef struct {
+    double weight;
+    Element* priority;
+    Element* value;
+    long handle;
+} pqueue_entry;
+
+class PriorityQueue : public Element {
+public:
+    std::vector<pqueue_entry> entries;
+    //positions[handle] is the position of the entry in entries, a handle is erased when its entry leaves the queue
+    std::unordered_map<long, long> positions;
+    List* compare;
+    long arity;
+    long handles;
+    bool greater;
+    
+    PriorityQueue(LispE* lisp, short l_pqueue, Element* comparator, long a) : arity(a), handles(0), greater(false), compare(NULL), Element(l_pqueue) {
+        if (comparator != null_ && comparator->type != l_lower && comparator->type != l_greater) {
+            compare = new List;
+            compare->append(comparator);
+            compare->append(null_);
+            compare->append(null_);
+            compare->increment();
+        }
+        else
+            greater = (comparator->type == l_greater);
+    }
+    
+    ~PriorityQueue() {
+        for (long i = 0; i < entries.size(); i++) {
+            entries[i].value->decrement();
+            if (entries[i].priority != NULL)
+                entries[i].priority->decrement();
+        }
+        if (compare != NULL)
+            compare->decrement();
+    }
+    
+    long size() {
+        return entries.size();
+    }
+    
+    bool Boolean() {
+        return !entries.empty();
+    }
+    
+    bool isEmpty() {
+        return entries.empty();
+    }
+    
+    //true if a must come before b
+    bool before(LispE* lisp, pqueue_entry& a, pqueue_entry& b) {
+        if (compare == NULL)
+            return greater?(a.weight > b.weight):(a.weight < b.weight);
+        
+        compare->liste[1] = a.priority->quoting();
+        compare->liste[2] = b.priority->quoting();
+        bool r;
+        try {
+            r = compare->eval_Boolean(lisp, compare->liste[0]->type);
+        }
+        catch (Error* err) {
+            arguments_release(lisp);
+            throw err;
+        }
+        arguments_release(lisp);
+        return r;
+    }
+    
+    inline void arguments_release(LispE* lisp) {
+        compare->liste[1]->release();
+        compare->liste[2]->release();
+        compare->liste[1] = null_;
+        compare->liste[2] = null_;
+    }
+    
+    inline void place(long pos, pqueue_entry& e) {
+        entries[pos] = e;
+        positions[e.handle] = pos;
+    }
+    
+    //If the comparator fails, the entries that were moved are put back where they were
+    void sift_up(LispE* lisp, long pos) {
+        pqueue_entry e = entries[pos];
+        long start = pos;
+        long parent, child;
+        try {
+            while (pos > 0) {
+                parent = (pos - 1) / arity;
+                if (!before(lisp, e, entries[parent]))
+                    break;
+                place(pos, entries[parent]);
+                pos = parent;
+            }
+        }
+        catch (Error* err) {
+            while (pos != start) {
+                child = start;
+                while ((child - 1) / arity != pos)
+                    child = (child - 1) / arity;
+                place(pos, entries[child]);
+                pos = child;
+            }
+            place(start, e);
+            throw err;
+        }
+        place(pos, e);
+    }
+    
+    void sift_down(LispE* lisp, long pos) {
+        pqueue_entry e = entries[pos];
+        long start = pos;
+        long nb = entries.size();
+        long child, best, last;
+        try {
+            while ((child = arity * pos + 1) < nb) {
+                best = child;
+                last = std::min(child + arity, nb);
+                for (child++; child < last; child++) {
+                    if (before(lisp, entries[child], entries[best]))
+                        best = child;
+                }
+                if (!before(lisp, entries[best], e))
+                    break;
+                place(pos, entries[best]);
+                pos = best;
+            }
+        }
+        catch (Error* err) {
+            while (pos != start) {
+                best = (pos - 1) / arity;
+                place(pos, entries[best]);
+                pos = best;
+            }
+            place(start, e);
+            throw err;
+        }
+        place(pos, e);
+    }
+    
+    pqueue_entry entry(Element* priority, Element* value) {
+        pqueue_entry e;
+        e.weight = 0;
+        e.priority = NULL;
+        if (compare == NULL) {
+            if (!priority->isNumber())
+                throw new Error("Error: priorities should be numbers in this priority queue");
+            e.weight = priority->asNumber();
+        }
+        else {
+            e.priority = priority->copying(false);
+            e.priority->increment();
+        }
+        e.value = value->copying(false);
+        e.value->increment();
+        e.handle = handles++;
+        positions[e.handle] = entries.size();
+        entries.push_back(e);
+        return e;
+    }
+    
+    void release(pqueue_entry& e) {
+        positions.erase(e.handle);
+        e.value->decrement();
+        if (e.priority != NULL)
+            e.priority->decrement();
+    }
+    
+    long push(LispE* lisp, Element* priority, Element* value) {
+        pqueue_entry e = entry(priority, value);
+        try {
+            sift_up(lisp, entries.size() - 1);
+        }
+        catch (Error* err) {
+            //sift_up has left the new entry at the end
+            entries.pop_back();
+            release(e);
+            throw err;
+        }
+        return e.handle;
+    }
+    
+    //When many values are added at once, the heap is rebuilt bottom-up in O(n)
+    Element* extend(LispE* lisp, Element* priorities, Element* values) {
+        long nb = priorities->size();
+        if (values != null_ && values->size() != nb)
+            throw new Error("Error: priorities and values should have the same size");
+        
+        long i;
+        //All priorities are checked before the queue is modified
+        if (compare == NULL) {
+            for (i = 0; i < nb; i++) {
+                if (!priorities->index(i)->isNumber())
+                    throw new Error("Error: priorities should be numbers in this priority queue");
+            }
+        }
+        
+        long first = entries.size();
+        long first_handle = handles;
+        //A comparator can fail in the middle of the reordering, the queue is then restored from this copy
+        std::vector<pqueue_entry> saved;
+        if (compare != NULL)
+            saved = entries;
+        
+        Integers* res = lisp->provideIntegers();
+        for (i = 0; i < nb; i++) {
+            if (values == null_)
+                res->liste.push_back(entry(priorities->index(i), priorities->index(i)).handle);
+            else
+                res->liste.push_back(entry(priorities->index(i), values->index(i)).handle);
+        }
+        
+        try {
+            if (nb > first) {
+                for (i = (entries.size() - 2) / arity; i >= 0 && entries.size() > 1; i--)
+                    sift_down(lisp, i);
+            }
+            else {
+                for (i = first; i < entries.size(); i++)
+                    sift_up(lisp, i);
+            }
+        }
+        catch (Error* err) {
+            res->release();
+            for (i = 0; i < entries.size(); i++) {
+                if (entries[i].handle >= first_handle)
+                    release(entries[i]);
+            }
+            entries = saved;
+            for (i = 0; i < first; i++)
+                positions[entries[i].handle] = i;
+            throw err;
+        }
+        return res;
+    }
+    
+    Element* pair(LispE* lisp, pqueue_entry& e) {
+        List* res = lisp->provideList();
+        if (e.priority == NULL)
+            res->append(lisp->provideNumber(e.weight));
+        else
+            res->append(e.priority);
+        res->append(e.value);
+        return res;
+    }
+    
+    Element* top(LispE* lisp) {
+        if (entries.empty())
+            return null_;
+        return pair(lisp, entries[0]);
+    }
+    
+    //The entry at pos is replaced with the last one, which is then moved up or down
+    //If the comparator fails, the queue is left unchanged
+    Element* removing(LispE* lisp, long pos) {
+        pqueue_entry e = entries[pos];
+        Element* res = pair(lisp, e);
+        pqueue_entry last = entries.back();
+        entries.pop_back();
+        if (pos != entries.size()) {
+            place(pos, last);
+            try {
+                if (pos > 0 && before(lisp, last, entries[(pos - 1) / arity]))
+                    sift_up(lisp, pos);
+                else
+                    sift_down(lisp, pos);
+            }
+            catch (Error* err) {
+                res->release();
+                entries.push_back(last);
+                positions[last.handle] = entries.size() - 1;
+                place(pos, e);
+                throw err;
+            }
+        }
+        release(e);
+        return res;
+    }
+    
+    Element* pop(LispE* lisp) {
+        if (entries.empty())
+            return null_;
+        return removing(lisp, 0);
+    }
+    
+    long position(long handle) {
+        std::unordered_map<long, long>::iterator it = positions.find(handle);
+        if (it == positions.end())
+            throw new Error("Error: unknown handle in priority queue");
+        return it->second;
+    }
+    
+    void update(LispE* lisp, long handle, Element* priority) {
+        long pos = position(handle);
+        pqueue_entry& e = entries[pos];
+        if (compare == NULL) {
+            if (!priority->isNumber())
+                throw new Error("Error: priorities should be numbers in this priority queue");
+            e.weight = priority->asNumber();
+        }
+        else {
+            Element* previous = e.priority;
+            e.priority = priority->copying(false);
+            e.priority->increment();
+            try {
+                if (pos > 0 && before(lisp, entries[pos], entries[(pos - 1) / arity]))
+                    sift_up(lisp, pos);
+                else
+                    sift_down(lisp, pos);
+            }
+            catch (Error* err) {
+                //the entry is still at pos, it gets its previous priority back
+                entries[pos].priority->decrement();
+                entries[pos].priority = previous;
+                throw err;
+            }
+            previous->decrement();
+            return;
+        }
+        if (pos > 0 && before(lisp, entries[pos], entries[(pos - 1) / arity]))
+            sift_up(lisp, pos);
+        else
+            sift_down(lisp, pos);
+    }
+    
+    Element* remove(LispE* lisp, long handle) {
+        return removing(lisp, position(handle));
+    }
+    
+    wstring asString(LispE* lisp) {
+        std::wstringstream s;
+        s << L"pqueue(" << entries.size() << L")";
+        return s.str();
+    }
+};
+
+class PriorityQueueMethod : public Element {
+public:
+    pqueue_command action;
+    short l_pqueue;
+    
+    PriorityQueueMethod(LispE* lisp, pqueue_command a, short l) : action(a), l_pqueue(l), Element(l_lib) {}
+    
+    PriorityQueue* queue(LispE* lisp) {
+        Element* q = lisp->get_variable(U"queue");
+        if (q->type != l_pqueue)
+            throw new Error("Error: the first element must be a priority queue");
+        return (PriorityQueue*)q;
+    }
+    
+    Element* eval(LispE* lisp) {
+        switch (action) {
+            case pqueue_create: {
+                long arity = lisp->get_variable(U"arity")->asInteger();
+                if (arity < 2)
+                    throw new Error("Error: the arity of a priority queue should be at least 2");
+                return new PriorityQueue(lisp, l_pqueue, lisp->get_variable(U"comparator"), arity);
+            }
+            case pqueue_push: {
+                PriorityQueue* q = queue(lisp);
+                Element* value = lisp->get_variable(U"value");
+                Element* priority = lisp->get_variable(U"priority");
+                if (value == null_)
+                    value = priority;
+                return lisp->provideInteger(q->push(lisp, priority, value));
+            }
+            case pqueue_extend: {
+                PriorityQueue* q = queue(lisp);
+                Element* priorities = lisp->get_variable(U"priorities");
+                if (!priorities->isList())
+                    throw new Error("Error: expecting a list of priorities");
+                return q->extend(lisp, priorities, lisp->get_variable(U"values"));
+            }
+            case pqueue_top:
+                return queue(lisp)->top(lisp);
+            case pqueue_pop:
+                return queue(lisp)->pop(lisp);
+            case pqueue_update: {
+                PriorityQueue* q = queue(lisp);
+                q->update(lisp, lisp->get_variable(U"handle")->asInteger(), lisp->get_variable(U"priority"));
+                return true_;
+            }
+            case pqueue_remove: {
+                PriorityQueue* q = queue(lisp);
+                return q->remove(lisp, lisp->get_variable(U"handle")->asInteger());
+            }
+            case pqueue_size:
+                return lisp->provideInteger(queue(lisp)->size());
+        }
+        return null_;
+    }
+    
+    wstring asString(LispE* lisp) {
+        switch (action) {
+            case pqueue_create:
+                return L"Creates a priority queue, priorities are numbers unless a comparator other than '<' or '>' is provided";
+            case pqueue_push:
+                return L"Pushes a value with its priority, returns a handle";
+            case pqueue_extend:
+                return L"Pushes a list of values with their priorities, returns the list of handles";
+            case pqueue_top:
+                return L"Returns the (priority value) that comes first";
+            case pqueue_pop:
+                return L"Removes and returns the (priority value) that comes first";
+            case pqueue_update:
+                return L"Changes the priority of the value associated with a handle";
+            case pqueue_remove:
+                return L"Removes and returns the (priority value) associated with a handle";
+            case pqueue_size:
+                return L"Returns the number of values in the priority queue";
+        }
+        return L"";
+    }
+};
+
 //We are also going to implement the body of the call
 void moduleSysteme(LispE* lisp) {
     //We first create the body of the function
@@ -1167,8 +1671,29 @@ void moduleSysteme(LispE* lisp) {
 
     //------------------------------------------
 
-    u_ustring w = U"chrono_";
+    lisp->extension("deflib pools_size ()", new Pools(lisp, pools_size));
+    lisp->extension("deflib pools_trim ((nb 0))", new Pools(lisp, pools_trim));
+    lisp->extension("deflib pools_maxsize ((nb -2) (pool \"\"))", new Pools(lisp, pools_maxsize));
+    lisp->extension("deflib cycles_statistics ()", new Pools(lisp, cycles_statistics));
+    lisp->extension("deflib cycles_threshold ((nb -2))", new Pools(lisp, cycles_threshold));
+
+    //------------------------------------------
+
+    u_ustring w = U"pqueue_";
     short identifier = lisp->encode(w);
+    lisp->extension("deflib pqueue ((comparator) (arity 4))", new PriorityQueueMethod(lisp, pqueue_create, identifier));
+    lisp->extension("deflib pqueue_push (queue priority (value))", new PriorityQueueMethod(lisp, pqueue_push, identifier));
+    lisp->extension("deflib pqueue_extend (queue priorities (values))", new PriorityQueueMethod(lisp, pqueue_extend, identifier));
+    lisp->extension("deflib pqueue_top (queue)", new PriorityQueueMethod(lisp, pqueue_top, identifier));
+    lisp->extension("deflib pqueue_pop (queue)", new PriorityQueueMethod(lisp, pqueue_pop, identifier));
+    lisp->extension("deflib pqueue_update (queue handle priority)", new PriorityQueueMethod(lisp, pqueue_update, identifier));
+    lisp->extension("deflib pqueue_remove (queue handle)", new PriorityQueueMethod(lisp, pqueue_remove, identifier));
+    lisp->extension("deflib pqueue_size (queue)", new PriorityQueueMethod(lisp, pqueue_size, identifier));
+
+    //------------------------------------------
+
+    w = U"chrono_";
+    identifier = lisp->encode(w);
     lisp->extension("deflib chrono ()", new Chrono(lisp, identifier));
     
     //------------------------------------------
@@ -16,6 +16,14 @@
 #include "tools.h"
 #include "lispe.h"
 
+#ifdef INTELINTRINSICS
+#ifdef WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
 #ifdef WIN32
 #include <io.h>
 #else
@@ -644,16 +652,12 @@ u_ustring Chaine_UTF8::u_insert_sep(u_ustring& s, u_ustring sep) {
 
 
 UWCHAR Chaine_UTF8::getachar(u_ustring& s, long& i) {
-    UWCHAR res;
-    try {
-        emojis.at(s[i]);
-        res = s[i++];
+    UWCHAR res = s[i];
+    if (c_is_emoji(res)) {
+        i++;
         while (i < s.size() && c_is_emojicomp(s[i])) {++i;}
         --i;
     }
-    catch (...) {
-        res = s[i];
-    }
     return res;
 }
 
@@ -683,7 +687,8 @@ void Chaine_UTF8::getandaddchar(u_ustring& s, u_ustring& res, long& i, long sz)
 // EMOJIS
 //------------------------------------------------------------------------
 bool Chaine_UTF8::c_is_emoji(UWCHAR c) {
-    return ((uint32_t)c >= min_emoji && emojis.find(c) != emojis.end());
+    //ASCII characters are never recorded as emojis
+    return ((uint32_t)c > 127 && (uint32_t)c >= min_emoji && emojis.find(c) != emojis.end());
 }
 
 bool Chaine_UTF8::c_is_emojicomp(UWCHAR c) {
@@ -1276,6 +1281,8 @@ Chaine_UTF8::Chaine_UTF8() : emojiscomplement(true) {
     wvowels[101] = 101;
     wvowels[79] = 79;
     wvowels[89] = 89;
+    
+    ascii_tables();
 }
 
 Exporting unsigned char c_utf8_to_unicode(unsigned char* utf, UWCHAR& code) {
@@ -1390,10 +1397,14 @@ Exporting u_ustring ujsonstring(u_ustring value) {
 //--------------------------------------------------------------------
 
 bool Chaine_UTF8::c_is_punctuation(u_uchar c) {
+    if (c < 128)
+        return (ascii_properties[c] & 4);
     return punctuations.check(c);
 }
 
 bool Chaine_UTF8::c_is_punctuation(wchar_t c) {
+    if ((uint32_t)c < 128)
+        return (ascii_properties[c] & 4);
     return punctuations.check(c);
 }
 
@@ -1421,10 +1432,14 @@ char Chaine_UTF8::c_is_alpha(unsigned char* m, long& i) {
 }
 
 char Chaine_UTF8::c_is_alpha(u_uchar v) {
+    if (v < 128)
+        return (ascii_properties[v] & 3);
     return (utf8codemin.check(v) + (2 * (char)utf8codemaj.check(v)));
 }
 
 char Chaine_UTF8::c_is_alpha(wchar_t v) {
+    if ((uint32_t)v < 128)
+        return (ascii_properties[v] & 3);
     return (utf8codemin.check(v) + (2 * (char)utf8codemaj.check(v)));
 }
 
@@ -1518,24 +1533,32 @@ bool Chaine_UTF8::s_is_lower(wstring& s) {
 }
 
 u_uchar Chaine_UTF8::uc_to_lower(u_uchar c) {
+    if (c < 128)
+        return ascii_lower[c];
     if (utf8codemaj.check(c))
         return utf8codemaj.at(c);
     return c;
 }
 
 u_uchar Chaine_UTF8::uc_to_upper(u_uchar c) {
+    if (c < 128)
+        return ascii_upper[c];
     if (utf8codemin.check(c))
         return utf8codemin.at(c);
     return c;
 }
 
 wchar_t Chaine_UTF8::c_to_lower(wchar_t c) {
+    if ((uint32_t)c < 128)
+        return ascii_lower[c];
     if (utf8codemaj.check(c))
         return utf8codemaj.at(c);
     return c;
 }
 
 wchar_t Chaine_UTF8::c_to_upper(wchar_t c) {
+    if ((uint32_t)c < 128)
+        return ascii_upper[c];
     if (utf8codemin.check(c))
         return utf8codemin.at(c);
     return c;
@@ -1569,19 +1592,70 @@ wstring Chaine_UTF8::s_to_upper(wstring& s) {
         res += (wchar_t)c_to_upper(s[i]);
     return res;
 }
+#ifdef INTELINTRINSICS
+//Case conversion of 4 ASCII characters at a time: the characters between first and last are shifted by delta
+//Returns false if one of these characters is not ASCII
+static inline bool ascii_case_block(u_uchar* src, u_uchar* dst, __m128i& first, __m128i& last, __m128i& delta) {
+    static const __m128i high = _mm_set1_epi32(0xFFFFFF80);
+    __m128i v = _mm_loadu_si128((__m128i*)src);
+    if (!_mm_testz_si128(v, high))
+        return false;
+    __m128i m = _mm_and_si128(_mm_cmpgt_epi32(v, first), _mm_cmplt_epi32(v, last));
+    _mm_storeu_si128((__m128i*)dst, _mm_add_epi32(v, _mm_and_si128(m, delta)));
+    return true;
+}
+#endif
+
+//Both conversions write in place in a string of the same size
 u_ustring Chaine_UTF8::u_to_lower(u_ustring& s) {
-    u_ustring res;
     long lg = s.size();
-    for (long i = 0; i < lg; i++)
-        res += (u_uchar)uc_to_lower(s[i]);
+    u_ustring res(lg, 0);
+    long i = 0;
+#ifdef INTELINTRINSICS
+    if (ascii_standard_case) {
+        __m128i first = _mm_set1_epi32('A' - 1);
+        __m128i last = _mm_set1_epi32('Z' + 1);
+        __m128i delta = _mm_set1_epi32(32);
+        u_uchar* src = (u_uchar*)s.c_str();
+        u_uchar* dst = &res[0];
+        while (i + 4 <= lg) {
+            if (ascii_case_block(src + i, dst + i, first, last, delta))
+                i += 4;
+            else {
+                for (long j = i + 4; i < j; i++)
+                    res[i] = uc_to_lower(s[i]);
+            }
+        }
+    }
+#endif
+    for (; i < lg; i++)
+        res[i] = uc_to_lower(s[i]);
     return res;
 }
 
 u_ustring Chaine_UTF8::u_to_upper(u_ustring& s) {
-    u_ustring res;
     long lg = s.size();
-    for (long i = 0; i < lg; i++)
-        res += (u_uchar)c_to_upper(s[i]);
+    u_ustring res(lg, 0);
+    long i = 0;
+#ifdef INTELINTRINSICS
+    if (ascii_standard_case) {
+        __m128i first = _mm_set1_epi32('a' - 1);
+        __m128i last = _mm_set1_epi32('z' + 1);
+        __m128i delta = _mm_set1_epi32(-32);
+        u_uchar* src = (u_uchar*)s.c_str();
+        u_uchar* dst = &res[0];
+        while (i + 4 <= lg) {
+            if (ascii_case_block(src + i, dst + i, first, last, delta))
+                i += 4;
+            else {
+                for (long j = i + 4; i < j; i++)
+                    res[i] = (u_uchar)c_to_upper(s[i]);
+            }
+        }
+    }
+#endif
+    for (; i < lg; i++)
+        res[i] = (u_uchar)c_to_upper(s[i]);
     return res;
 }
 
@@ -2010,25 +2084,195 @@ u_ustring s_umiddle(u_ustring& s, long l, long nb) {
     return s.substr(l, nb);
 }
 //------------------------------------------------------------------------
-string s_replacingstring(string& s, string reg, string rep) {
-    string neo;
+//Sub-string search
+//A position is a candidate when both the first and the last characters of the
+//sub-string match. With AVX2, candidates are detected 8 (UTF-32) or 32 (UTF-8) at a time.
+//As with std::basic_string::find, these functions return -1 (npos) when the sub-string is not found.
+#ifdef INTELINTRINSICS
+static inline long first_bit(uint32_t mask) {
+    long k = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        k++;
+    }
+    return k;
+}
+
+static inline long last_bit(uint32_t mask) {
+    long k = 31;
+    while (!(mask & 0x80000000)) {
+        mask <<= 1;
+        k--;
+    }
+    return k;
+}
+#endif
+
+long u_find(u_ustring& s, u_ustring& sub, long from) {
+    long n = s.size();
+    long m = sub.size();
+    if (from < 0 || from > n)
+        return -1;
+    if (!m)
+        return from;
+    if (m > n - from)
+        return -1;
+
+    u_uchar* h = (u_uchar*)s.c_str();
+    u_uchar* p = (u_uchar*)sub.c_str();
+    u_uchar first = p[0];
+    u_uchar last = p[m - 1];
+    long end = n - m;
+    long i = from;
+    long k;
+
+#ifdef INTELINTRINSICS
+    __m256i vfirst = _mm256_set1_epi32(first);
+    __m256i vlast = _mm256_set1_epi32(last);
+    uint32_t mask;
+    for (; i + 7 <= end; i += 8) {
+        mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(
+                        _mm256_cmpeq_epi32(vfirst, _mm256_loadu_si256((__m256i*)(h + i))),
+                        _mm256_cmpeq_epi32(vlast, _mm256_loadu_si256((__m256i*)(h + i + m - 1))))));
+        while (mask) {
+            k = first_bit(mask);
+            if (!memcmp(h + i + k, p, m * sizeof(u_uchar)))
+                return i + k;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i <= end; i++) {
+        if (h[i] == first && h[i + m - 1] == last) {
+            for (k = 1; k < m && h[i + k] == p[k]; k++) {}
+            if (k >= m)
+                return i;
+        }
+    }
+    return -1;
+}
+
+//Last position <= from, where sub can be found
+long u_rfind(u_ustring& s, u_ustring& sub, long from) {
+    long n = s.size();
+    long m = sub.size();
+    if (m > n)
+        return -1;
+    long i = n - m;
+    if (from >= 0 && from < i)
+        i = from;
+    if (!m)
+        return i;
+
+    u_uchar* h = (u_uchar*)s.c_str();
+    u_uchar* p = (u_uchar*)sub.c_str();
+    u_uchar first = p[0];
+    u_uchar last = p[m - 1];
+    long k;
+
+#ifdef INTELINTRINSICS
+    __m256i vfirst = _mm256_set1_epi32(first);
+    __m256i vlast = _mm256_set1_epi32(last);
+    uint32_t mask;
+    //i is the last position in the block
+    for (; i >= 7; i -= 8) {
+        mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(
+                        _mm256_cmpeq_epi32(vfirst, _mm256_loadu_si256((__m256i*)(h + i - 7))),
+                        _mm256_cmpeq_epi32(vlast, _mm256_loadu_si256((__m256i*)(h + i - 7 + m - 1))))));
+        while (mask) {
+            k = last_bit(mask);
+            if (!memcmp(h + i - 7 + k, p, m * sizeof(u_uchar)))
+                return i - 7 + k;
+            mask &= ~((uint32_t)1 << k);
+        }
+    }
+#endif
+
+    for (; i >= 0; i--) {
+        if (h[i] == first && h[i + m - 1] == last) {
+            for (k = 1; k < m && h[i + k] == p[k]; k++) {}
+            if (k >= m)
+                return i;
+        }
+    }
+    return -1;
+}
+
+long s_find(string& s, string& sub, long from) {
+    long n = s.size();
+    long m = sub.size();
+    if (from < 0 || from > n)
+        return -1;
+    if (!m)
+        return from;
+    if (m > n - from)
+        return -1;
+    
+    char* h = (char*)s.c_str();
+    char* p = (char*)sub.c_str();
+    long end = n - m;
+    long i = from;
+
+#ifdef INTELINTRINSICS
+    __m256i vfirst = _mm256_set1_epi8(p[0]);
+    __m256i vlast = _mm256_set1_epi8(p[m - 1]);
+    uint32_t mask;
+    long k;
+    for (; i + 31 <= end; i += 32) {
+        mask = _mm256_movemask_epi8(_mm256_and_si256(
+                        _mm256_cmpeq_epi8(vfirst, _mm256_loadu_si256((__m256i*)(h + i))),
+                        _mm256_cmpeq_epi8(vlast, _mm256_loadu_si256((__m256i*)(h + i + m - 1)))));
+        while (mask) {
+            k = first_bit(mask);
+            if (!memcmp(h + i + k, p, m))
+                return i + k;
+            mask &= mask - 1;
+        }
+    }
+#endif
     
+    //memchr is usually vectorized in the C library
+    char* c;
+    while (i <= end) {
+        c = (char*)memchr(h + i, p[0], end - i + 1);
+        if (c == NULL)
+            return -1;
+        i = c - h;
+        if (h[i + m - 1] == p[m - 1] && !memcmp(c, p, m))
+            return i;
+        i++;
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------
+//Replacements are done in one pass: positions are first collected, then
+//the result is built at once in a string of the right size.
+string s_replacingstring(string& s, string reg, string rep) {
     long gsz = reg.size();
     if (!gsz)
         return s;
     
-    long rsz = s.size();
-    long from = 0;
+    vector<long> positions;
+    long from = s_find(s, reg, 0);
+    while (from != -1) {
+        positions.push_back(from);
+        from = s_find(s, reg, from + gsz);
+    }
     
-    long foundHere;
-    while ((foundHere = s.find(reg, from)) != string::npos) {
-        if (foundHere != from)
-            neo += s.substr(from, foundHere - from);
+    if (!positions.size())
+        return s;
+    
+    string neo;
+    neo.reserve(s.size() + positions.size() * rep.size() - positions.size() * gsz);
+    from = 0;
+    for (long i = 0; i < positions.size(); i++) {
+        neo.append(s, from, positions[i] - from);
         neo += rep;
-        from = foundHere + gsz;
+        from = positions[i] + gsz;
     }
-    if (from < rsz)
-        neo += s.substr(from, rsz - from);
+    neo.append(s, from, s.size() - from);
     return neo;
 }
 
@@ -2074,49 +2318,47 @@ u_ustring s_ureplacechar(u_ustring& s, u_uchar reg, u_ustring rep) {
     return neo;
 }
 
-u_ustring s_ureplacestring(u_ustring& s, u_ustring reg, u_ustring rep) {
-    u_ustring neo;
-    
+static long u_replacing(u_ustring& s, u_ustring& reg, u_ustring& rep, u_ustring& neo) {
     long gsz = reg.size();
-    if (!gsz)
-        return s;
+    vector<long> positions;
+    long from = u_find(s, reg, 0);
+    while (from != -1) {
+        positions.push_back(from);
+        from = u_find(s, reg, from + gsz);
+    }
     
-    long rsz = s.size();
-    long from = 0;
+    if (!positions.size())
+        return 0;
     
-    long foundHere;
-    while ((foundHere = s.find(reg, from)) != string::npos) {
-        if (foundHere != from)
-            neo += s.substr(from, foundHere - from);
+    neo.reserve(s.size() + positions.size() * rep.size() - positions.size() * gsz);
+    from = 0;
+    for (long i = 0; i < positions.size(); i++) {
+        neo.append(s, from, positions[i] - from);
         neo += rep;
-        from = foundHere + gsz;
+        from = positions[i] + gsz;
     }
-    if (from < rsz)
-        neo += s.substr(from, rsz - from);
+    neo.append(s, from, s.size() - from);
+    return positions.size();
+}
+
+u_ustring s_ureplacestring(u_ustring& s, u_ustring reg, u_ustring rep) {
+    if (!reg.size())
+        return s;
+    
+    u_ustring neo;
+    if (!u_replacing(s, reg, rep, neo))
+        return s;
     return neo;
 }
 
 long nb_ureplacestring(u_ustring& s, u_ustring reg, u_ustring rep) {
-    u_ustring neo;
-    
-    long gsz = reg.size();
-    if (!gsz)
+    if (!reg.size())
         return 0;
     
-    long rsz = s.size();
-    long from = 0;
-    long nb = 0;
-    long foundHere;
-    while ((foundHere = s.find(reg, from)) != string::npos) {
-        if (foundHere != from)
-            neo += s.substr(from, foundHere - from);
-        neo += rep;
-        from = foundHere + gsz;
-        nb++;
-    }
-    if (from < rsz)
-        neo += s.substr(from, rsz - from);
-    s = neo;
+    u_ustring neo;
+    long nb = u_replacing(s, reg, rep, neo);
+    if (nb)
+        s = neo;
     return nb;
 }
 
@@ -3635,113 +3877,110 @@ Exporting bool c_char_index_insert(string& s, string c, long x) {
     return true;
 }
 
-static inline char* concatstrings(char* str, char* ctn, long& i, long& size_str, long size_ctn) {
-    if ((i + size_ctn) >= size_str) {
-        size_str += size_ctn;
-        size_str <<= 1;
-        char* s = new char[size_str];
-        memcpy(s, str, i);
-        delete[] str;
-        str = s;
-    }
-    memcpy(str+i,ctn, size_ctn);
-    i += size_ctn;
-    str[i] = 0;
-    return str;
-}
 //------------------------------------------------------------------------
 Exporting void s_unicode_to_utf8_clean(string& s, wstring& str) {
     s = "";
     s_unicode_to_utf8(s, str);
 }
 
-Exporting void s_unicode_to_utf8(string& s, wstring& str) {
-    long i = 0;
-    char inter[5];
-    long ineo = 0;
-    long sz = str.size();
-    if (!sz)
-        return;
+//ASCII characters are converted 16 at a time with SSE4 (available with -mavx2)
+//The conversions stop at the first 0 character, as the C string based versions did.
+#ifdef INTELINTRINSICS
+//Are these 16 characters in [1..127]?
+static inline bool ascii_block(__m128i* a) {
+    static const __m128i high = _mm_set1_epi32(0xFFFFFF80);
+    __m128i zero = _mm_setzero_si128();
+    __m128i o = _mm_or_si128(_mm_or_si128(a[0], a[1]), _mm_or_si128(a[2], a[3]));
+    __m128i z = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(a[0], zero), _mm_cmpeq_epi32(a[1], zero)),
+                             _mm_or_si128(_mm_cmpeq_epi32(a[2], zero), _mm_cmpeq_epi32(a[3], zero)));
+    return (_mm_testz_si128(o, high) && _mm_testz_si128(z, z));
+}
+#endif
 
-    long szo = 1 + (sz << 1);
-    char* neo = new char[szo];
-    neo[0] = 0;
-    long nb;
+template <class T> static void unicode_to_utf8(string& s, T* str, long sz) {
+    long i = 0;
+    long nb = 0;
+#ifdef INTELINTRINSICS
+    __m128i a[4];
+#endif
 
+    //First, we compute the size of the result
     while (i < sz) {
-        if (str[i] < 0x0080 && ineo < szo-1) {
-            neo[ineo++] = (char)str[i];
-            i++;
-            continue;
+#ifdef INTELINTRINSICS
+        if (sizeof(T) == 4) {
+            while (i + 16 <= sz) {
+                a[0] = _mm_loadu_si128((__m128i*)(str + i));
+                a[1] = _mm_loadu_si128((__m128i*)(str + i + 4));
+                a[2] = _mm_loadu_si128((__m128i*)(str + i + 8));
+                a[3] = _mm_loadu_si128((__m128i*)(str + i + 12));
+                if (!ascii_block(a))
+                    break;
+                i += 16;
+                nb += 16;
+            }
+            if (i == sz)
+                break;
+        }
+#endif
+        if (!str[i])
+            break;
+        if (str[i] < 0x0080)
+            nb++;
+        else {
+            if ((UWCHAR)str[i] < 0x0800)
+                nb += 2;
+            else
+                nb += ((UWCHAR)str[i] < 0x10000)?3:4;
         }
-        
-        nb = c_unicode_to_utf8(str[i], (uchar*)inter);
-        neo = concatstrings(neo,inter,ineo, szo, nb);
         i++;
     }
     
-    neo[ineo] = 0;
-    s += neo;
-    delete[] neo;
-}
-
-Exporting void s_unicode_to_utf8(string& s, u_ustring& str) {
-    long i = 0;
-    char inter[5];
-    long ineo = 0;
-    long sz = str.size();
-    if (!sz)
+    if (!nb)
         return;
-
-    long szo = 1 + (sz << 1);
-    char* neo = new char[szo];
-    neo[0] = 0;
-    long nb;
-
+    
+    sz = i;
+    long ineo = s.size();
+    //c_unicode_to_utf8 writes a final 0
+    s.resize(ineo + nb + 1);
+    unsigned char* neo = (unsigned char*)&s[0];
+    i = 0;
     while (i < sz) {
-        if (str[i] < 0x0080 && ineo < szo-1) {
-            neo[ineo++] = (char)str[i];
-            i++;
-            continue;
+#ifdef INTELINTRINSICS
+        if (sizeof(T) == 4) {
+            while (i + 16 <= sz) {
+                a[0] = _mm_loadu_si128((__m128i*)(str + i));
+                a[1] = _mm_loadu_si128((__m128i*)(str + i + 4));
+                a[2] = _mm_loadu_si128((__m128i*)(str + i + 8));
+                a[3] = _mm_loadu_si128((__m128i*)(str + i + 12));
+                if (!ascii_block(a))
+                    break;
+                _mm_storeu_si128((__m128i*)(neo + ineo), _mm_packus_epi16(_mm_packus_epi32(a[0], a[1]), _mm_packus_epi32(a[2], a[3])));
+                i += 16;
+                ineo += 16;
+            }
+            if (i == sz)
+                break;
         }
-        
-        nb = c_unicode_to_utf8(str[i], (uchar*)inter);
-        neo = concatstrings(neo,inter,ineo, szo, nb);
+#endif
+        if (str[i] < 0x0080)
+            neo[ineo++] = (unsigned char)str[i];
+        else
+            ineo += c_unicode_to_utf8(str[i], neo + ineo);
         i++;
     }
-    
-    neo[ineo] = 0;
-    s += neo;
-    delete[] neo;
+    s.resize(ineo);
 }
 
-Exporting void s_unicode_to_utf8(string& s, wchar_t* str, long sz) {
-	long i = 0;
-	char inter[5];
-	long ineo = 0;
-	if (!sz)
-		return;
-
-	long szo = 1 + (sz << 1);
-	char* neo = new char[szo];
-	neo[0] = 0;
-	long nb;
-
-	while (i < sz) {
-		if (str[i] < 0x0080 && ineo < szo - 1) {
-			neo[ineo++] = (char)str[i];
-			i++;
-			continue;
-		}
+Exporting void s_unicode_to_utf8(string& s, wstring& str) {
+    unicode_to_utf8(s, (wchar_t*)str.c_str(), str.size());
+}
 
-		nb = c_unicode_to_utf8(str[i], (uchar*)inter);
-		neo = concatstrings(neo, inter, ineo, szo, nb);
-		i++;
-	}
+Exporting void s_unicode_to_utf8(string& s, u_ustring& str) {
+    unicode_to_utf8(s, (u_uchar*)str.c_str(), str.size());
+}
 
-	neo[ineo] = 0;
-	s += neo;
-	delete[] neo;
+Exporting void s_unicode_to_utf8(string& s, wchar_t* str, long sz) {
+    unicode_to_utf8(s, str, sz);
 }
 
 Exporting void s_utf8_to_unicode_clean(wstring& w, unsigned char* str , long sz) {
@@ -3749,10 +3988,61 @@ Exporting void s_utf8_to_unicode_clean(wstring& w, unsigned char* str , long sz)
     s_utf8_to_unicode(w, str , sz);
 }
 
+//The result is written in place in w, ASCII bytes are converted 16 at a time
+template <class T> static void utf8_to_unicode(std::basic_string<T>& w, unsigned char* str, long sz) {
+    long ineo = w.size();
+    w.resize(ineo + sz);
+    T* neo = (T*)&w[0];
+    
+    UWCHAR c;
+    uchar nb;
+#ifdef INTELINTRINSICS
+    __m128i b;
+    __m128i zero = _mm_setzero_si128();
+#endif
+    
+    while (sz > 0) {
+#ifdef INTELINTRINSICS
+        if (sizeof(T) == 4) {
+            while (sz >= 16) {
+                b = _mm_loadu_si128((__m128i*)str);
+                if (_mm_movemask_epi8(_mm_or_si128(b, _mm_cmpeq_epi8(b, zero))))
+                    break;
+                _mm_storeu_si128((__m128i*)(neo + ineo), _mm_cvtepu8_epi32(b));
+                _mm_storeu_si128((__m128i*)(neo + ineo + 4), _mm_cvtepu8_epi32(_mm_srli_si128(b, 4)));
+                _mm_storeu_si128((__m128i*)(neo + ineo + 8), _mm_cvtepu8_epi32(_mm_srli_si128(b, 8)));
+                _mm_storeu_si128((__m128i*)(neo + ineo + 12), _mm_cvtepu8_epi32(_mm_srli_si128(b, 12)));
+                str += 16;
+                sz -= 16;
+                ineo += 16;
+            }
+            if (!sz)
+                break;
+        }
+#endif
+        sz--;
+        if (*str & 0x80) {
+            nb = c_utf8_to_unicode(str, c);
+            str += nb + 1;
+            sz = (sz >= nb)?sz-nb:0;
+            if (!c)
+                break;
+            neo[ineo++] = c;
+            continue;
+        }
+        if (!*str)
+            break;
+        neo[ineo++] = *str;
+        ++str;
+    }
+    w.resize(ineo);
+}
+
 Exporting void s_utf8_to_unicode(wstring& w, unsigned char* str , long sz) {
     if (!sz)
         return;
 
+#ifdef WIN32
     long ineo = 0;
     wchar_t* neo = new wchar_t[sz+1];
     neo[0] = 0;
@@ -3760,7 +4050,6 @@ Exporting void s_utf8_to_unicode(wstring& w, unsigned char* str , long sz) {
     UWCHAR c;
     uchar nb;
     
-#ifdef WIN32
     UWCHAR c16;
     while (sz--) {
         if (*str & 0x80) {
@@ -3780,52 +4069,19 @@ Exporting void s_utf8_to_unicode(wstring& w, unsigned char* str , long sz) {
         neo[ineo++] = (wchar_t)*str;
         ++str;
     }
-#else
-    while (sz--) {
-        if (*str & 0x80) {
-            nb = c_utf8_to_unicode(str, c);
-            str += nb+1;
-            sz = (sz >= nb)?sz-nb:0;
-            neo[ineo++] = c;
-            continue;
-        }
-        neo[ineo++] = (wchar_t)*str;
-        ++str;
-    }
-#endif
     
     neo[ineo] = 0;
     w += neo;
     delete[] neo;
+#else
+    utf8_to_unicode(w, str, sz);
+#endif
 }
 
 Exporting void s_utf8_to_unicode(u_ustring& w, unsigned char* str , long sz) {
     if (!sz)
         return;
-
-    long ineo = 0;
-    u_uchar* neo = new u_uchar[sz+1];
-    neo[0] = 0;
-
-    UWCHAR c;
-    uchar nb;
-    
-
-    while (sz--) {
-        if (*str & 0x80) {
-            nb = c_utf8_to_unicode(str, c);
-            str += nb+1;
-            sz = (sz >= nb)?sz-nb:0;
-            neo[ineo++] = c;
-            continue;
-        }
-        neo[ineo++] = (wchar_t)*str;
-        ++str;
-    }
-    
-    neo[ineo] = 0;
-    w += neo;
-    delete[] neo;
+    utf8_to_unicode(w, str, sz);
 }
 //------------------------------------------------------------------------
 void s_split(string& s, string& splitter, vector<string>& vs, bool keepblanks) {